@@ -0,0 +1,174 @@
+#include "stdafx.h"
+#if !defined (_AQUEUE_CPP)
+#define _AQUEUE_CPP
+
+#include <algorithm>
+#include "AQueue.h"
+
+// Returns the smallest power of two that is >= <n> (at least 1).
+template <typename T, typename ARRAY>
+size_t AQueue<T, ARRAY>::round_up(size_t n)
+{
+	size_t capacity = 1;
+	while (capacity < n)
+		capacity <<= 1;
+	return capacity;
+}
+
+// Constructor.
+template <typename T, typename ARRAY>
+AQueue<T, ARRAY>::AQueue(size_t size_hint)
+	:queue_(round_up(size_hint)), head_{ 0 }, count_{ 0 }
+{
+}
+
+// Copy constructor.  The copy is unwrapped so its front is at index 0.
+template <typename T, typename ARRAY>
+AQueue<T, ARRAY>::AQueue(const AQueue<T, ARRAY> &rhs)
+	:queue_(rhs.queue_.size()), head_{ 0 }, count_{ rhs.count_ }
+{
+	const size_t mask = rhs.queue_.size() - 1;
+	for (size_t i = 0; i < rhs.count_; ++i)
+		queue_[i] = rhs.queue_[(rhs.head_ + i) & mask];
+}
+
+// Assignment operator.
+template <typename T, typename ARRAY>
+AQueue<T, ARRAY> &AQueue<T, ARRAY>::operator= (const AQueue<T, ARRAY> &rhs)
+{
+	if (this != &rhs) {
+		AQueue<T, ARRAY> temp(rhs);
+		swap(temp);
+	}
+	return *this;
+}
+
+// The <ARRAY> releases the buffer.
+template <typename T, typename ARRAY>
+AQueue<T, ARRAY>::~AQueue(void)
+{
+}
+
+// Place a <new_item> at the tail of the queue.  Throws the <Overflow>
+// exception if the buffer cannot grow.
+template <typename T, typename ARRAY>
+void AQueue<T, ARRAY>::enqueue(const T &new_item)
+{
+	if (count_ == queue_.size()) {
+		try {
+			grow(queue_.size() * 2);
+		}
+		catch (...) {
+			throw Overflow();
+		}
+	}
+
+	queue_[(head_ + count_) & (queue_.size() - 1)] = new_item;
+	++count_;
+}
+
+// Remove the front item on the queue.  Throws the <Underflow>
+// exception if the queue is empty.
+template <typename T, typename ARRAY>
+void AQueue<T, ARRAY>::dequeue(void)
+{
+	if (count_ == 0)
+		throw Underflow();
+
+	// Drop the reference held by the vacated slot right away.
+	queue_[head_] = T();
+	head_ = (head_ + 1) & (queue_.size() - 1);
+	--count_;
+}
+
+// Returns the front queue item without removing it.
+// Throws the <Underflow> exception if the queue is empty.
+template <typename T, typename ARRAY>
+T AQueue<T, ARRAY>::front(void) const
+{
+	if (count_ == 0)
+		throw Underflow();
+	return queue_[head_];
+}
+
+// Place the <n> items starting at <items> at the tail of the queue.
+template <typename T, typename ARRAY>
+void AQueue<T, ARRAY>::enqueue_n(const T *items, size_t n)
+{
+	if (count_ + n > queue_.size()) {
+		try {
+			grow(round_up(count_ + n));
+		}
+		catch (...) {
+			throw Overflow();
+		}
+	}
+
+	const size_t mask = queue_.size() - 1;
+	for (size_t i = 0; i < n; ++i)
+		queue_[(head_ + count_ + i) & mask] = items[i];
+	count_ += n;
+}
+
+// Remove up to <n> items from the front into <items>.
+template <typename T, typename ARRAY>
+size_t AQueue<T, ARRAY>::dequeue_n(T *items, size_t n)
+{
+	if (n > count_)
+		n = count_;
+
+	const size_t mask = queue_.size() - 1;
+	for (size_t i = 0; i < n; ++i) {
+		T &slot = queue_[(head_ + i) & mask];
+		items[i] = slot;
+		slot = T();
+	}
+	head_ = (head_ + n) & mask;
+	count_ -= n;
+	return n;
+}
+
+// Compare this queue with <rhs> for equality.
+template <typename T, typename ARRAY>
+bool AQueue<T, ARRAY>::operator== (const AQueue<T, ARRAY> &rhs) const
+{
+	if (count_ != rhs.count_)
+		return false;
+
+	const size_t mask = queue_.size() - 1;
+	const size_t rhs_mask = rhs.queue_.size() - 1;
+	for (size_t i = 0; i < count_; ++i)
+		if (!(queue_[(head_ + i) & mask] == rhs.queue_[(rhs.head_ + i) & rhs_mask]))
+			return false;
+	return true;
+}
+
+template <typename T, typename ARRAY>
+bool AQueue<T, ARRAY>::operator!= (const AQueue<T, ARRAY> &rhs) const
+{
+	return !(*this == rhs);
+}
+
+// Efficiently swap the contents of this <AQueue> with <new_aqueue>.
+// Does not throw an exception.
+template <typename T, typename ARRAY>
+void AQueue<T, ARRAY>::swap(AQueue<T, ARRAY> &new_aqueue)
+{
+	queue_.swap(new_aqueue.queue_);
+	std::swap(head_, new_aqueue.head_);
+	std::swap(count_, new_aqueue.count_);
+}
+
+// Move the items into a buffer of <capacity> slots, unwrapping the ring.
+template <typename T, typename ARRAY>
+void AQueue<T, ARRAY>::grow(size_t capacity)
+{
+	ARRAY temp(capacity);
+	const size_t mask = queue_.size() - 1;
+	for (size_t i = 0; i < count_; ++i)
+		temp[i] = queue_[(head_ + i) & mask];
+	queue_.swap(temp);
+	head_ = 0;
+}
+
+#endif /* _AQUEUE_CPP */
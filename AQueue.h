@@ -0,0 +1,120 @@
+#pragma once
+#ifndef _AQUEUE_H
+#define _AQUEUE_H
+
+// This header defines "size_t"
+#include <stdlib.h>
+
+#include "Queue.h"
+#include "Array.h"
+
+/**
+* @class AQueue
+* @brief Defines a generic "first-in/first-out" (FIFO) Abstract Data
+* Type (ADT) using a circular buffer stored in an <ARRAY>.
+*
+* The capacity is always a power of two so wrapping an index around
+* the end of the buffer is a mask instead of a division.  When the
+* buffer is full <enqueue> moves the items into an <ARRAY> of twice
+* the size, so unlike the <LQueue> there is no allocation per item and
+* consecutive items are adjacent in memory.
+*/
+template <typename T, typename ARRAY = Array<T> >
+class AQueue
+{
+public:
+	// = Exceptions thrown by methods in this class.
+	class Underflow {};
+	class Overflow {};
+
+	// = Initialization, assignment, and termination methods.
+
+	// Constructor.  <size_hint> is rounded up to a power of two.
+	AQueue(size_t size_hint = 0);
+
+	// Copy constructor.
+	AQueue(const AQueue<T, ARRAY> &rhs);
+
+	// Assignment operator.
+	AQueue<T, ARRAY> &operator= (const AQueue<T, ARRAY> &rhs);
+
+	// Perform actions needed when queue goes out of scope.
+	~AQueue(void);
+
+	// = Classic Queue operations.
+
+	// Place a <new_item> at the tail of the queue.  Throws the
+	// <Overflow> exception if the buffer cannot grow, e.g., if memory
+	// is exhausted.
+	void enqueue(const T &new_item);
+
+	// Remove the front item on the queue.  Throws the <Underflow>
+	// exception if the queue is empty.
+	void dequeue(void);
+
+	// Returns the front queue item without removing it.
+	// Throws the <Underflow> exception if the queue is empty.
+	T front(void) const;
+
+	// Place the <n> items starting at <items> at the tail of the queue,
+	// growing the buffer at most once.  Throws the <Overflow> exception
+	// if the buffer cannot grow.
+	void enqueue_n(const T *items, size_t n);
+
+	// Remove up to <n> items from the front into <items>.  Returns the
+	// number removed.
+	size_t dequeue_n(T *items, size_t n);
+
+	// = Check boundary conditions for Queue operations.
+
+	// Returns 1 if the queue is empty, otherwise returns 0.
+	bool is_empty(void) const {
+		return count_ == 0;
+	}
+
+	// Returns 1 if the queue is full, otherwise returns 0.  The buffer
+	// grows on demand so the queue is never full.
+	bool is_full(void) const {
+		return false;
+	}
+
+	// Returns the current number of elements in the queue.
+	size_t size(void) const {
+		return count_;
+	}
+
+	// Compare this queue with <rhs> for equality.  Returns true if the
+	// size's of the two queues are equal and all the elements from 0
+	// .. size are equal, else false.
+	bool operator== (const AQueue<T, ARRAY> &rhs) const;
+
+	// Compare this queue with <rhs> for inequality.
+	bool operator!= (const AQueue<T, ARRAY> &rhs) const;
+
+	// Efficiently swap the contents of this <AQueue> with <new_aqueue>.
+	// Does not throw an exception.
+	void swap(AQueue<T, ARRAY> &new_aqueue);
+
+	// = Traits for the class.
+	typedef T value_type;
+
+private:
+	// Move the items into a buffer of <capacity> slots, which must be
+	// a power of two not smaller than <count_>.
+	void grow(size_t capacity);
+
+	// Returns the smallest power of two that is >= <n> (at least 1).
+	static size_t round_up(size_t n);
+
+	ARRAY queue_;
+	// The circular buffer, its size is always a power of two.
+
+	size_t head_;
+	// Index of the front item.
+
+	size_t count_;
+	// Number of items that are currently in the queue.
+};
+
+#include "AQueue.cpp"
+#endif /* _AQUEUE_H */
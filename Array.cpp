@@ -0,0 +1,72 @@
+#include "stdafx.h"
+#if !defined (_ARRAY_CPP)
+#define _ARRAY_CPP
+
+#include <algorithm>
+#include "Array.h"
+
+// Construct an array holding <size> default constructed elements.
+template <typename T>
+Array<T>::Array(size_t size)
+	:size_{ size }, array_{ size > 0 ? new T[size] : nullptr }
+{
+}
+
+// Copy constructor.
+template <typename T>
+Array<T>::Array(const Array<T> &rhs)
+	:size_{ rhs.size_ }, array_{ rhs.size_ > 0 ? new T[rhs.size_] : nullptr }
+{
+	std::copy(rhs.array_, rhs.array_ + rhs.size_, array_);
+}
+
+// Assignment operator.
+template <typename T>
+Array<T> &Array<T>::operator= (const Array<T> &rhs)
+{
+	if (this != &rhs) {
+		Array<T> temp(rhs);
+		swap(temp);
+	}
+	return *this;
+}
+
+// Release the storage.
+template <typename T>
+Array<T>::~Array(void)
+{
+	delete[] array_;
+}
+
+template <typename T>
+T &Array<T>::operator[] (size_t index)
+{
+	return array_[index];
+}
+
+template <typename T>
+const T &Array<T>::operator[] (size_t index) const
+{
+	return array_[index];
+}
+
+// Return the element at <index>.  Throws the <Out_Of_Range>
+// exception if <index> is not less than size().
+template <typename T>
+const T &Array<T>::get(size_t index) const
+{
+	if (index >= size_)
+		throw Out_Of_Range();
+	return array_[index];
+}
+
+// Efficiently swap the contents of this <Array> with <new_array>.
+// Does not throw an exception.
+template <typename T>
+void Array<T>::swap(Array<T> &new_array)
+{
+	std::swap(size_, new_array.size_);
+	std::swap(array_, new_array.array_);
+}
+
+#endif /* _ARRAY_CPP */
@@ -0,0 +1,66 @@
+#pragma once
+#ifndef _ARRAY_H
+#define _ARRAY_H
+
+// This header defines "size_t"
+#include <stdlib.h>
+
+#include <stdexcept>
+
+/**
+* @class Array
+* @brief Defines a fixed size array whose storage is one contiguous
+*        block allocated from the free store.  Used as the storage
+*        strategy of <AQueue>.
+*/
+template <typename T>
+class Array
+{
+public:
+	// = Exceptions thrown by methods in this class.
+	class Out_Of_Range {};
+
+	/// Trait for the element type.
+	typedef T value_type;
+
+	// = Initialization, assignment, and termination methods.
+
+	// Construct an array holding <size> default constructed elements.
+	Array(size_t size = 0);
+
+	// Copy constructor.
+	Array(const Array<T> &rhs);
+
+	// Assignment operator.
+	Array<T> &operator= (const Array<T> &rhs);
+
+	// Release the storage.
+	~Array(void);
+
+	// = Element access.  These do not check <index>.
+	T &operator[] (size_t index);
+	const T &operator[] (size_t index) const;
+
+	// Return the element at <index>.  Throws the <Out_Of_Range>
+	// exception if <index> is not less than size().
+	const T &get(size_t index) const;
+
+	// Returns the number of elements in the array.
+	size_t size(void) const {
+		return size_;
+	}
+
+	// Efficiently swap the contents of this <Array> with <new_array>.
+	// Does not throw an exception.
+	void swap(Array<T> &new_array);
+
+private:
+	// Number of elements in <array_>.
+	size_t size_;
+
+	// Contiguous storage for the elements.
+	T *array_;
+};
+
+#include "Array.cpp"
+#endif /* _ARRAY_H */
@@ -0,0 +1,974 @@
+#include "stdafx.h"
+#if !defined (_Benchmark_CPP)
+#define _Benchmark_CPP
+
+#include <iostream>
+#include <iomanip>
+#include <algorithm>
+#include <vector>
+#include <chrono>
+#include <thread>
+#include <atomic>
+#include <sstream>
+#include <stdint.h>
+#include <cmath>
+#include <streambuf>
+#include <memory>
+
+#include "Benchmark.h"
+#include "Interpreter.h"
+#include "LQueue.h"
+#include "AQueue.h"
+#include "STLQueue.h"
+#include "MPMC_Queue.h"
+#include "Leaf_Node.h"
+#include "Node_Reclaimer.h"
+#include "Eval_Visitor.h"
+#include "Print_Visitor.h"
+#include "Fused_Visitor.h"
+#include "Pruning_Visitor.h"
+#include "Tree_Range.h"
+#include "Level_Frontier.h"
+#include "Options.h"
+#include "Workload_Generator.h"
+#include "Perf_Counters.h"
+
+namespace
+{
+	/// Names of the traversal orders accepted by Tree::begin.
+	const char *traversal_orders[] = { "Levelorder", "Preorder", "Postorder", "Inorder" };
+
+	/// Names of the queue strategies accepted by Options::set_queue_type.
+	const char *queue_types[] = { "LQueue", "AQueue", "STLQueue" };
+
+	/// Names of the Workload_Generator shapes, the deep ones last.
+	const char *expression_shapes[] = { "balanced", "random", "left", "right" };
+
+	/// Hardware counters read around each timed run, nullptr unless the
+	/// -e option asked for them.
+	Perf_Counters *counters = nullptr;
+
+	/// Counts of each timed run of the last measure, for report.
+	std::vector<Perf_Sample> counted;
+
+	/// Returns the time one call of <f> takes in seconds.
+	template <typename FUNCTION>
+	double time_of(FUNCTION f)
+	{
+		std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+		f();
+		std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+		return elapsed.count();
+	}
+
+	/// Run <setup>, <f> and <teardown> <warmup> times, then
+	/// <repetitions> more times, and return how long <f> took in each
+	/// of the later runs in seconds.  The hardware counters, if any,
+	/// are read around <f> in the later runs and kept in <counted>.
+	template <typename SETUP, typename FUNCTION, typename TEARDOWN>
+	std::vector<double> measure(size_t warmup, size_t repetitions,
+		SETUP setup, FUNCTION f, TEARDOWN teardown)
+	{
+		std::vector<double> seconds;
+		counted.clear();
+		for (size_t i = 0; i < warmup + repetitions; ++i) {
+			setup();
+			const bool counting = counters != nullptr && i >= warmup;
+			if (counting)
+				counters->start();
+			const double elapsed = time_of(f);
+			if (counting)
+				counted.push_back(counters->stop());
+			teardown();
+			if (i >= warmup)
+				seconds.push_back(elapsed);
+		}
+		return seconds;
+	}
+
+	/// Same as above for a <f> that needs no setup.
+	template <typename FUNCTION>
+	std::vector<double> measure(size_t warmup, size_t repetitions, FUNCTION f)
+	{
+		return measure(warmup, repetitions, []() {}, f, []() {});
+	}
+
+	/// Returns the spec of a Workload_Generator for expressions of
+	/// <terms> operands in <shape>.
+	Workload_Spec make_spec(const std::string &shape, size_t terms)
+	{
+		std::ostringstream spec;
+		spec << "operands=" << terms << ",shape=" << shape;
+		return Workload_Generator::parse_spec(spec.str());
+	}
+
+	/// Returns the number of nodes of <tree>.
+	size_t count_nodes(const TREE &tree)
+	{
+		return std::distance(tree.begin<Preorder>(), tree.end<Preorder>());
+	}
+
+	/// Stream buffer that throws away what is written to it, so the
+	/// Print_Visitor is timed without the terminal.
+	class Null_Buffer : public std::streambuf
+	{
+	protected:
+		int_type overflow(int_type c) {
+			return traits_type::not_eof(c);
+		}
+
+		std::streamsize xsputn(const char *, std::streamsize count) {
+			return count;
+		}
+	};
+
+	/// Orders trees by node address, item() is not defined for operators.
+	bool node_less(const TREE &lhs, const TREE &rhs)
+	{
+		return lhs.get_root() < rhs.get_root();
+	}
+
+	bool is_leaf(const TREE &tree)
+	{
+		return tree.get_root()->left() == nullptr && tree.get_root()->right() == nullptr;
+	}
+
+	/// Visit <tree> in level order through the Queue interface, the same
+	/// way Level_Order_Tree_Iterator_Impl does.  Returns the node count.
+	size_t breadth_first(const TREE &tree, QUEUE &queue)
+	{
+		size_t count = 0;
+		queue.enqueue(tree);
+		while (!queue.is_empty()) {
+			TREE front = queue.front();
+			queue.dequeue();
+			++count;
+			if (!front.left().is_null())
+				queue.enqueue(front.left());
+			if (!front.right().is_null())
+				queue.enqueue(front.right());
+		}
+		return count;
+	}
+
+	/// Level order walk of <tree> a whole level at a time, moving each
+	/// level through <queue> with one enqueue_n and one drain.
+	template <typename QUEUE>
+	size_t breadth_first_bulk(const TREE &tree, QUEUE &queue)
+	{
+		size_t count = 0;
+		std::vector<TREE> frontier(1, tree);
+		std::vector<TREE> children;
+		while (!frontier.empty()) {
+			count += frontier.size();
+			children.clear();
+			for (size_t i = 0; i < frontier.size(); ++i) {
+				if (!frontier[i].left().is_null())
+					children.push_back(frontier[i].left());
+				if (!frontier[i].right().is_null())
+					children.push_back(frontier[i].right());
+			}
+			queue.enqueue_n(children.data(), children.size());
+			frontier.clear();
+			queue.drain(frontier);
+		}
+		return count;
+	}
+
+	/// Model of a set associative LRU cache of <sets> * <ways> blocks
+	/// of <block> bytes.  Counting its misses over the node addresses
+	/// of a traversal compares layouts without hardware counters, and
+	/// the same way on every machine.
+	class Cache_Model
+	{
+	public:
+		Cache_Model(size_t block, size_t sets, size_t ways)
+			:block_(block), sets_(sets), ways_(ways),
+			tags_(sets * ways, 0), clock_(0), misses_(0)
+		{}
+
+		/// Touch the <size> bytes at <ptr>.
+		void access(const void *ptr, size_t size) {
+			const uintptr_t first = reinterpret_cast<uintptr_t>(ptr) / block_;
+			const uintptr_t last = (reinterpret_cast<uintptr_t>(ptr) + size - 1) / block_;
+			for (uintptr_t block = first; block <= last; ++block)
+				touch(block + 1);
+		}
+
+		size_t misses(void) const {
+			return misses_;
+		}
+
+	private:
+		void touch(uintptr_t block) {
+			Entry *set = &tags_[(block % sets_) * ways_];
+			Entry *victim = set;
+			for (size_t way = 0; way < ways_; ++way) {
+				if (set[way].block_ == block) {
+					set[way].used_ = ++clock_;
+					return;
+				}
+				if (set[way].used_ < victim->used_)
+					victim = &set[way];
+			}
+			++misses_;
+			victim->block_ = block;
+			victim->used_ = ++clock_;
+		}
+
+		struct Entry
+		{
+			Entry(int) :block_(0), used_(0) {}
+			uintptr_t block_;
+			size_t used_;
+		};
+
+		size_t block_;
+		size_t sets_;
+		size_t ways_;
+		std::vector<Entry> tags_;
+		size_t clock_;
+		size_t misses_;
+	};
+
+	/// Modelled misses per node visited.
+	struct Misses
+	{
+		double l1_;
+		double tlb_;
+	};
+
+	/// Returns the misses per node of a 32 KB 8 way L1 data cache with
+	/// 64 byte lines and of a 64 entry 4 way TLB of 4 KB pages while
+	/// <tree> is walked in <ORDER>.
+	template <typename ORDER>
+	Misses modelled_misses(const TREE &tree)
+	{
+		Cache_Model l1(64, 64, 8);
+		Cache_Model tlb(4096, 16, 4);
+		size_t nodes = 0;
+		for (Tree_Order_Iterator<int, ORDER> it = tree.begin<ORDER>(),
+			end = tree.end<ORDER>(); it != end; ++it, ++nodes) {
+			const Component_Node<int> *node = it->get_root();
+			l1.access(node, node->node_size());
+			tlb.access(node, node->node_size());
+		}
+		Misses misses = { 0, 0 };
+		if (nodes != 0) {
+			misses.l1_ = static_cast<double>(l1.misses()) / nodes;
+			misses.tlb_ = static_cast<double>(tlb.misses()) / nodes;
+		}
+		return misses;
+	}
+
+	/// Same as modelled_misses for 4096 walks from the root down to a
+	/// leaf, turning left or right pseudo randomly, per node visited.
+	/// This is the access pattern the van Emde Boas layout is for.
+	Misses modelled_path_misses(const TREE &tree)
+	{
+		Cache_Model l1(64, 64, 8);
+		Cache_Model tlb(4096, 16, 4);
+		size_t nodes = 0;
+		unsigned int random = 12345;
+		for (size_t path = 0; path < 4096; ++path) {
+			for (const Component_Node<int> *node = tree.get_root(); node != nullptr; ++nodes) {
+				l1.access(node, node->node_size());
+				tlb.access(node, node->node_size());
+				random = random * 1103515245 + 12345;
+				const Component_Node<int> *next = (random >> 16) & 1 ? node->left() : node->right();
+				node = next != nullptr ? next : node->right();
+			}
+		}
+		Misses misses = { 0, 0 };
+		if (nodes != 0) {
+			misses.l1_ = static_cast<double>(l1.misses()) / nodes;
+			misses.tlb_ = static_cast<double>(tlb.misses()) / nodes;
+		}
+		return misses;
+	}
+
+	/// Returns a perfectly balanced sum of <terms> ones, children built
+	/// before their parent as the Interpreter does.  The Interpreter
+	/// itself does not keep the nesting of make_expression, its trees
+	/// come out much deeper.
+	Component_Node<int> *balanced_sum(size_t terms)
+	{
+		if (terms <= 1)
+			return new LEAF_NODE(1);
+		Component_Node<int> *left = balanced_sum(terms / 2);
+		Component_Node<int> *right = balanced_sum(terms - terms / 2);
+		return new COMPOSITE_ADD_NODE(left, right);
+	}
+
+	/// Returns a balanced sum of <terms> products of two ones, so half
+	/// of the nodes hang under a product.
+	Component_Node<int> *sum_of_products(size_t terms)
+	{
+		if (terms <= 1)
+			return new COMPOSITE_MULTIPLY_NODE(new LEAF_NODE(1), new LEAF_NODE(1));
+		Component_Node<int> *left = sum_of_products(terms / 2);
+		Component_Node<int> *right = sum_of_products(terms - terms / 2);
+		return new COMPOSITE_ADD_NODE(left, right);
+	}
+
+	/// Print the number of <values>, and their minimum, median, mean,
+	/// sample standard deviation and maximum, in <unit>.
+	void print_summary(const std::string &name, const std::string &unit,
+		std::vector<double> values)
+	{
+		std::sort(values.begin(), values.end());
+
+		const size_t n = values.size();
+		if (n == 0)
+			return;
+
+		double sum = 0;
+		for (size_t i = 0; i < n; ++i)
+			sum += values[i];
+		const double mean = sum / n;
+
+		double squares = 0;
+		for (size_t i = 0; i < n; ++i)
+			squares += (values[i] - mean) * (values[i] - mean);
+		const double stddev = n > 1 ? std::sqrt(squares / (n - 1)) : 0;
+
+		const double median = n % 2 ? values[n / 2] : (values[n / 2 - 1] + values[n / 2]) / 2;
+
+		std::cout << std::fixed << std::setprecision(3)
+			<< name << "," << unit << "," << n << ","
+			<< values.front() << "," << median << "," << mean << ","
+			<< stddev << "," << values.back() << std::endl;
+	}
+
+	/// Keeps the optimizer from discarding results.
+	volatile size_t sink;
+}
+
+// Ctor
+Benchmark::Benchmark(size_t terms, size_t repetitions, size_t warmup)
+	:terms_{ terms }, repetitions_{ repetitions }, warmup_{ warmup }, tree_{}, nodes_{ 0 }
+{
+	Interpreter_Context context;
+	Interpreter interpreter;
+	tree_ = interpreter.interpret(context, make_expression(terms_));
+	nodes_ = count_nodes(tree_);
+}
+
+// Dtor
+Benchmark::~Benchmark(void)
+{
+}
+
+// Return a sum of <terms> operands whose parentheses nest as a balanced
+// tree.  The Interpreter does not keep that nesting, so its tree comes
+// out much deeper; balanced_sum builds the balanced tree itself.
+std::string
+Benchmark::make_expression(size_t terms)
+{
+	if (terms <= 1)
+		return "1";
+	return "(" + make_expression(terms / 2) + "+" + make_expression(terms - terms / 2) + ")";
+}
+
+// Run all the benchmarks.
+void
+Benchmark::run(void)
+{
+	// Read the hardware counters around every timed run if asked to.
+	std::unique_ptr<Perf_Counters> perf_counters;
+	if (Options::instance()->hardware_counters()) {
+		perf_counters.reset(new Perf_Counters);
+		if (perf_counters->is_available())
+			counters = perf_counters.get();
+		else
+			std::cerr << "hardware counters are not available" << std::endl;
+	}
+
+	std::cout << "benchmark,variant,unit,samples,min,median,mean,stddev,max" << std::endl;
+	interpreter();
+	workloads();
+	traversals();
+	visitors();
+	refcounting();
+	iterator_algorithms();
+	queue_strategies();
+	queue_contention();
+	reclamation();
+	layouts();
+	allocation();
+
+	counters = nullptr;
+}
+
+// Interpret, and parse and build separately, expressions of each
+// shape with 10, 1000 and <terms_> operands.  Only the build is timed
+// for Symbol::build, the parse tree is made and both trees are freed
+// around it.  The "left" and "right" shapes are as deep as they are
+// long and Symbol::build and ~Symbol recurse once per level, so they
+// stop at <deep_terms> operands.
+void
+Benchmark::interpreter(void)
+{
+	const size_t sizes[] = { 10, 1000, terms_ };
+	const size_t deep_terms = 10000;
+	size_t done = 0;
+
+	for (size_t i = 0; i < sizeof sizes / sizeof *sizes; ++i) {
+		if (sizes[i] > terms_ || sizes[i] <= done)
+			continue;
+		done = sizes[i];
+
+		for (size_t j = 0; j < sizeof expression_shapes / sizeof *expression_shapes; ++j) {
+			if (j > 1 && sizes[i] > deep_terms)
+				continue;
+
+			Interpreter_Context context;
+			Interpreter interpreter;
+			const std::string expression =
+				Workload_Generator(make_spec(expression_shapes[j], sizes[i])).expression();
+			const size_t nodes = count_nodes(interpreter.interpret(context, expression));
+
+			std::ostringstream variant;
+			variant << expression_shapes[j] << ":" << sizes[i];
+
+			report("interpret," + variant.str(), measure(warmup_, repetitions_, [&]() {
+				TREE tree = interpreter.interpret(context, expression);
+				sink = tree.is_null();
+			}), nodes);
+
+			Symbol *parsed = nullptr;
+			report("parse," + variant.str(), measure(warmup_, repetitions_, []() {}, [&]() {
+				parsed = interpreter.parse(context, expression);
+			}, [&]() {
+				Interpreter::release(parsed);
+			}), nodes);
+
+			TREE built;
+			report("build," + variant.str(), measure(warmup_, repetitions_, [&]() {
+				parsed = interpreter.parse(context, expression);
+			}, [&]() {
+				built = Interpreter::build(parsed);
+			}, [&]() {
+				Interpreter::release(parsed);
+				built = TREE();
+			}), nodes);
+		}
+	}
+}
+
+// Build trees of <terms_> operands in each shape directly with the
+// Workload_Generator, then evaluate them, and walk them with
+// parallel_for_each and a level at a time.  Nothing here recurses, so
+// the deep shapes run at full size too.
+void
+Benchmark::workloads(void)
+{
+	for (size_t j = 0; j < sizeof expression_shapes / sizeof *expression_shapes; ++j) {
+		const Workload_Spec spec = make_spec(expression_shapes[j], terms_);
+		const std::string shape = expression_shapes[j];
+		TREE tree = Workload_Generator(spec).tree();
+		const size_t nodes = count_nodes(tree);
+
+		TREE built;
+		report("generate_tree," + shape, measure(warmup_, repetitions_, []() {}, [&]() {
+			built = Workload_Generator(spec).tree();
+		}, [&]() {
+			built = TREE();
+		}), nodes);
+
+		report("tree_stats," + shape, measure(warmup_, repetitions_, [&]() {
+			Tree_Stats stats(tree.get_root());
+			sink = stats.height_;
+		}), nodes);
+
+		report("generated_eval," + shape, measure(warmup_, repetitions_, [&]() {
+			Post_Order_Eval_Visitor<int> eval_visitor(tree);
+			for (Tree_Order_Iterator<int, Postorder> it = tree.begin<Postorder>(),
+				end = tree.end<Postorder>(); it != end; ++it)
+				it->get_root()->accept(eval_visitor);
+			sink = eval_visitor.yield();
+		}), nodes);
+
+		// Count the leaves on 1 to 8 threads, each worker in its own
+		// cache line.
+		for (size_t threads = 1; threads <= 8; threads *= 2) {
+			std::ostringstream name;
+			name << "parallel_for_each," << shape << ":" << threads;
+			report(name.str(), measure(warmup_, repetitions_, [&]() {
+				const size_t STRIDE = 64 / sizeof(size_t);
+				std::vector<size_t> leaves(threads * STRIDE);
+				parallel_for_each(tree, [&](Component_Node<int> *node, size_t worker) {
+					if (node->left() == nullptr && node->right() == nullptr)
+						++leaves[worker * STRIDE];
+				}, threads);
+				size_t total = 0;
+				for (size_t i = 0; i < threads; ++i)
+					total += leaves[i * STRIDE];
+				sink = total;
+			}), nodes);
+		}
+
+		// Count the leaves a level at a time, with the level order
+		// iterator and with a Level_Frontier on 1 to 8 threads.
+		report("level_order_iterator," + shape, measure(warmup_, repetitions_, [&]() {
+			size_t leaves = 0;
+			for (Tree_Order_Iterator<int, Levelorder> it = tree.begin<Levelorder>(),
+				end = tree.end<Levelorder>(); it != end; ++it)
+				if (it.get_node()->left() == nullptr && it.get_node()->right() == nullptr)
+					++leaves;
+			sink = leaves;
+		}), nodes);
+
+		for (size_t threads = 1; threads <= 8; threads *= 2) {
+			std::ostringstream name;
+			name << "level_frontier," << shape << ":" << threads;
+			report(name.str(), measure(warmup_, repetitions_, [&]() {
+				const size_t STRIDE = 64 / sizeof(size_t);
+				std::vector<size_t> leaves(threads * STRIDE);
+				for (Level_Frontier<int> level(tree, threads); !level.empty();)
+					level.expand([&](Component_Node<int> *node, size_t worker) {
+						if (node->left() == nullptr && node->right() == nullptr)
+							++leaves[worker * STRIDE];
+					});
+				size_t total = 0;
+				for (size_t i = 0; i < threads; ++i)
+					total += leaves[i * STRIDE];
+				sink = total;
+			}), nodes);
+		}
+	}
+}
+
+// Walk the tree with Tree::begin in each traversal order with each
+// queue strategy.  Only the level order iterator uses a queue, the
+// other orders are there for comparison.
+void
+Benchmark::traversals(void)
+{
+	Options *options = Options::instance();
+	const std::string queue_type = options->queue_type();
+
+	for (size_t q = 0; q < sizeof queue_types / sizeof *queue_types; ++q) {
+		options->set_queue_type(queue_types[q]);
+
+		for (size_t i = 0; i < sizeof traversal_orders / sizeof *traversal_orders; ++i) {
+			const std::string order = traversal_orders[i];
+			TREE &tree = tree_;
+
+			report("traversal," + order + ":" + queue_types[q], measure(warmup_, repetitions_, [&]() {
+				sink = std::distance(tree.begin(order), tree.end(order));
+			}), nodes_);
+		}
+	}
+
+	options->set_queue_type(queue_type);
+
+	// Seek to pseudo random positions in each depth first order, each
+	// seek going down from the root, against stepping over every node.
+	const TREE &tree = tree_;
+	const size_t seeks = 1000;
+	seek<Preorder>("Preorder", tree, seeks);
+	seek<Postorder>("Postorder", tree, seeks);
+	seek<Inorder>("Inorder", tree, seeks);
+	report("seek,std::distance:Preorder", measure(warmup_, repetitions_, [&]() {
+		sink = std::distance(tree.begin<Preorder>(), tree.end<Preorder>());
+	}), 1);
+	report("seek,operator-:Preorder", measure(warmup_, repetitions_, [&]() {
+		sink = tree.end<Preorder>() - tree.begin<Preorder>();
+	}), 1);
+}
+
+// Time <seeks> seeks to pseudo random positions of the <ORDER> walk
+// of <tree>.
+template <typename ORDER>
+void
+Benchmark::seek(const std::string &order, const TREE &tree, size_t seeks)
+{
+	const size_t nodes = tree.is_null() ? 0 : tree.get_root()->subtree_size();
+	if (nodes == 0)
+		return;
+	report("seek," + order, measure(warmup_, repetitions_, [&]() {
+		Tree_Order_Iterator<int, ORDER> it = tree.begin<ORDER>();
+		unsigned int random = 12345;
+		for (size_t i = 0; i < seeks; ++i) {
+			random = random * 1103515245 + 12345;
+			it.seek(random % nodes);
+			sink = it.position();
+		}
+	}), seeks);
+}
+
+// Evaluate the tree with both Eval_Visitors the way Main does and with
+// Tree::evaluate, and print it with the Print_Visitor into a stream
+// buffer that discards the output.  Then evaluate and print it in two
+// walks and in one with a Fused_Visitor.  Last, count the terms of a
+// sum of products with Count_Terms, which leaves out the nodes under
+// each product, against a walk of every node.
+void
+Benchmark::visitors(void)
+{
+	const TREE &tree = tree_;
+
+	report("visitor,Post_Order_Eval_Visitor", measure(warmup_, repetitions_, [&]() {
+		Post_Order_Eval_Visitor<int> eval_visitor(tree);
+		for (Tree_Order_Iterator<int, Postorder> it = tree.begin<Postorder>(),
+			end = tree.end<Postorder>(); it != end; ++it)
+			it->get_root()->accept(eval_visitor);
+		sink = eval_visitor.yield();
+	}), nodes_);
+
+	report("visitor,Pre_Order_Eval_Visitor", measure(warmup_, repetitions_, [&]() {
+		Pre_Order_Eval_Visitor<int> eval_visitor(tree);
+		for (Tree_Order_Iterator<int, Reverse<Preorder> > it = tree.rbegin<Preorder>(),
+			end = tree.rend<Preorder>(); it != end; ++it)
+			it.get_node()->accept(eval_visitor);
+		sink = eval_visitor.yield();
+	}), nodes_);
+
+	report("visitor,Tree::evaluate", measure(warmup_, repetitions_, [&]() {
+		sink = tree.evaluate();
+	}), nodes_);
+
+	Null_Buffer discard;
+	std::streambuf *output = std::cout.rdbuf(&discard);
+	std::vector<double> seconds = measure(warmup_, repetitions_, [&]() {
+		Print_Visitor print_visitor;
+		for (Tree_Order_Iterator<int, Preorder> it = tree.begin<Preorder>(),
+			end = tree.end<Preorder>(); it != end; ++it)
+			it->get_root()->accept(print_visitor);
+	});
+	std::cout.rdbuf(output);
+	report("visitor,Print_Visitor", seconds, nodes_);
+
+	// Evaluating and printing in the same post order walk, one walk
+	// for each and then one walk with both.
+	std::cout.rdbuf(&discard);
+	seconds = measure(warmup_, repetitions_, [&]() {
+		Post_Order_Eval_Visitor<int> eval_visitor(tree);
+		Print_Visitor print_visitor;
+		for (Tree_Order_Iterator<int, Postorder> it = tree.begin<Postorder>(),
+			end = tree.end<Postorder>(); it != end; ++it)
+			it.get_node()->accept(eval_visitor);
+		for (Tree_Order_Iterator<int, Postorder> it = tree.begin<Postorder>(),
+			end = tree.end<Postorder>(); it != end; ++it)
+			it.get_node()->accept(print_visitor);
+		sink = eval_visitor.yield();
+	});
+	std::cout.rdbuf(output);
+	report("visitor,separate:eval+print", seconds, nodes_);
+
+	std::cout.rdbuf(&discard);
+	seconds = measure(warmup_, repetitions_, [&]() {
+		Post_Order_Eval_Visitor<int> eval_visitor(tree);
+		Print_Visitor print_visitor;
+		Fused_Visitor<Post_Order_Eval_Visitor<int>, Print_Visitor> both(eval_visitor, print_visitor);
+		for (Tree_Order_Iterator<int, Postorder> it = tree.begin<Postorder>(),
+			end = tree.end<Postorder>(); it != end; ++it)
+			it.get_node()->accept(both);
+		sink = eval_visitor.yield();
+	});
+	std::cout.rdbuf(output);
+	report("visitor,Fused_Visitor:eval+print", seconds, nodes_);
+
+	const TREE products(sum_of_products(terms_));
+	const size_t nodes = count_nodes(products);
+
+	report("visitor,traverse_pruned:all", measure(warmup_, repetitions_, [&]() {
+		Pruning_Visitor all;
+		sink = traverse_pruned<Preorder>(products, all);
+	}), nodes);
+
+	report("visitor,traverse_pruned:Count_Terms", measure(warmup_, repetitions_, [&]() {
+		Count_Terms terms;
+		traverse_pruned<Preorder>(products, terms);
+		sink = terms.terms();
+	}), nodes);
+}
+
+// Reference count churn: copy a handle to the root into a vector and
+// drop the copies, assign a handle to every node in turn, and make the
+// handles to the children of every node.
+void
+Benchmark::refcounting(void)
+{
+	const TREE &tree = tree_;
+	const std::vector<TREE> nodes(tree.begin<Preorder>(), tree.end<Preorder>());
+	std::vector<TREE> copies;
+	copies.reserve(nodes.size());
+
+	report("refcount,copy", measure(warmup_, repetitions_, [&]() {
+		copies.assign(nodes.size(), tree);
+		copies.clear();
+	}), nodes.size());
+
+	report("refcount,assign", measure(warmup_, repetitions_, [&]() {
+		TREE handle;
+		for (size_t i = 0; i < nodes.size(); ++i)
+			handle = nodes[i];
+		sink = handle.is_null();
+	}), nodes.size());
+
+	report("refcount,children", measure(warmup_, repetitions_, [&]() {
+		size_t nulls = 0;
+		for (size_t i = 0; i < nodes.size(); ++i)
+			nulls += nodes[i].left().is_null() + nodes[i].right().is_null();
+		sink = nulls;
+	}), nodes.size());
+}
+
+// Standard algorithms over Tree_Iterator for each traversal order.
+// adjacent_find and max_element copy the iterator at every step and
+// the explicit loop uses the postincrement operator.
+void
+Benchmark::iterator_algorithms(void)
+{
+	for (size_t i = 0; i < sizeof traversal_orders / sizeof *traversal_orders; ++i) {
+		const std::string order = traversal_orders[i];
+		TREE &tree = tree_;
+
+		report("count_if," + order, measure(warmup_, repetitions_, [&]() {
+			sink = std::count_if(tree.begin(order), tree.end(order), is_leaf);
+		}), nodes_);
+
+		report("copy," + order, measure(warmup_, repetitions_, [&]() {
+			std::vector<TREE> nodes;
+			std::copy(tree.begin(order), tree.end(order), std::back_inserter(nodes));
+			sink = nodes.size();
+		}), nodes_);
+
+		report("adjacent_find," + order, measure(warmup_, repetitions_, [&]() {
+			sink = std::adjacent_find(tree.begin(order), tree.end(order)) == tree.end(order);
+		}), nodes_);
+
+		report("max_element," + order, measure(warmup_, repetitions_, [&]() {
+			sink = (*std::max_element(tree.begin(order), tree.end(order), node_less)).is_null();
+		}), nodes_);
+
+		report("postincrement," + order, measure(warmup_, repetitions_, [&]() {
+			size_t count = 0;
+			for (Tree_Iterator<int> it = tree.begin(order), end = tree.end(order); it != end;)
+				count += (*it++).is_null() ? 0 : 1;
+			sink = count;
+		}), nodes_);
+	}
+}
+
+// Breadth first traversal with each Queue strategy, over a tree that is
+// balanced by construction, so its last level holds half of the nodes.
+void
+Benchmark::queue_strategies(void)
+{
+	const size_t size_hint = 50;
+	const TREE tree(balanced_sum(terms_));
+	const size_t nodes = count_nodes(tree);
+	const Free_List_Stats before = LQueue_Node<TREE>::free_list_stats();
+
+	report("breadth_first,LQueue", measure(warmup_, repetitions_, [&]() {
+		LQUEUE_ADAPTER queue(size_hint);
+		sink = breadth_first(tree, queue);
+	}), nodes);
+
+	report("breadth_first,STLQueue", measure(warmup_, repetitions_, [&]() {
+		STLQueue_Adapter<TREE> queue(size_hint);
+		sink = breadth_first(tree, queue);
+	}), nodes);
+
+	report("breadth_first,AQueue", measure(warmup_, repetitions_, [&]() {
+		AQUEUE_ADAPTER queue(size_hint);
+		sink = breadth_first(tree, queue);
+	}), nodes);
+
+	report("breadth_first_bulk,LQueue", measure(warmup_, repetitions_, [&]() {
+		LQUEUE_ADAPTER queue(size_hint);
+		sink = breadth_first_bulk(tree, queue);
+	}), nodes);
+
+	report("breadth_first_bulk,STLQueue", measure(warmup_, repetitions_, [&]() {
+		STLQueue_Adapter<TREE> queue(size_hint);
+		sink = breadth_first_bulk(tree, queue);
+	}), nodes);
+
+	report("breadth_first_bulk,AQueue", measure(warmup_, repetitions_, [&]() {
+		AQUEUE_ADAPTER queue(size_hint);
+		sink = breadth_first_bulk(tree, queue);
+	}), nodes);
+
+	// How the LQueue node allocations above were served.
+	const Free_List_Stats after = LQueue_Node<TREE>::free_list_stats();
+	report_value("free_list,LQueue:hits", "allocations", static_cast<double>(after.hits_ - before.hits_));
+	report_value("free_list,LQueue:refills", "allocations", static_cast<double>(after.refills_ - before.refills_));
+	report_value("free_list,LQueue:misses", "allocations", static_cast<double>(after.misses_ - before.misses_));
+	report_value("free_list,LQueue:spills", "nodes", static_cast<double>(after.spills_ - before.spills_));
+}
+
+// Hand trees from producer to consumer threads through an
+// MPMC_Queue.  Every producer builds its own one node trees and moves
+// them into the queue so the reference counts are never shared.
+void
+Benchmark::queue_contention(void)
+{
+	const size_t items = nodes_;
+
+	for (size_t threads = 1; threads <= 32; threads *= 2) {
+		std::vector<double> seconds = measure(warmup_, repetitions_, [&]() {
+			MPMC_Queue<TREE> queue(1024);
+			std::atomic<size_t> consumed(0);
+			std::vector<std::thread> workers;
+
+			for (size_t p = 0; p < threads; ++p)
+				workers.push_back(std::thread([&, p]() {
+					for (size_t i = p; i < items; i += threads) {
+						TREE tree(new LEAF_NODE(static_cast<int>(i)));
+						while (!queue.try_push(std::move(tree)))
+							std::this_thread::yield();
+					}
+				}));
+
+			for (size_t c = 0; c < threads; ++c)
+				workers.push_back(std::thread([&]() {
+					TREE tree;
+					while (consumed.load(std::memory_order_relaxed) < items) {
+						if (queue.try_pop(tree))
+							consumed.fetch_add(1, std::memory_order_relaxed);
+						else
+							std::this_thread::yield();
+					}
+				}));
+
+			for (size_t i = 0; i < workers.size(); ++i)
+				workers[i].join();
+		});
+
+		std::ostringstream name;
+		name << "mpmc_contention," << threads << "x" << threads;
+		report(name.str(), seconds, items);
+	}
+}
+
+// Time only the release of the last handle, the trees are built
+// before the timed part.  In background mode that is the cost seen by
+// the releasing thread; flush waits for the teardown itself untimed.
+void
+Benchmark::reclamation(void)
+{
+	Interpreter_Context context;
+	Interpreter interpreter;
+	const std::string expression = make_expression(terms_);
+	Node_Reclaimer<int> *reclaimer = Node_Reclaimer<int>::instance();
+	const bool was_background = reclaimer->is_background();
+
+	const char *modes[] = { "release,inline", "release,background" };
+	for (size_t mode = 0; mode < 2; ++mode) {
+		reclaimer->background(mode == 1);
+
+		TREE tree;
+		report(modes[mode], measure(warmup_, repetitions_, [&]() {
+			tree = interpreter.interpret(context, expression);
+		}, [&]() {
+			tree = TREE();
+		}, [&]() {
+			reclaimer->flush();
+		}), nodes_);
+	}
+
+	reclaimer->background(was_background);
+}
+
+// Evaluate and walk a balanced tree as built and after Tree::compact
+// in each layout.
+void
+Benchmark::layouts(void)
+{
+	const char *names[] = { "built", "preorder", "levelorder", "van_emde_boas" };
+	const Tree_Layout layouts[] = { PREORDER_LAYOUT, LEVEL_ORDER_LAYOUT, VAN_EMDE_BOAS_LAYOUT };
+	const TREE built(balanced_sum(terms_));
+
+	for (size_t i = 0; i < 4; ++i) {
+		const TREE tree = i == 0 ? built : built.compact(layouts[i - 1]);
+		const std::string name = names[i];
+
+		report("layout_eval," + name, measure(warmup_, repetitions_, [&]() {
+			Post_Order_Eval_Visitor<int> eval_visitor(tree);
+			for (Tree_Order_Iterator<int, Postorder> it = tree.begin<Postorder>(),
+				end = tree.end<Postorder>(); it != end; ++it)
+				it->get_root()->accept(eval_visitor);
+			sink = eval_visitor.yield();
+		}), nodes_);
+
+		report("layout_levelorder," + name, measure(warmup_, repetitions_, [&]() {
+			sink = std::distance(tree.begin<Levelorder>(), tree.end<Levelorder>());
+		}), nodes_);
+
+		const Misses postorder = modelled_misses<Postorder>(tree);
+		const Misses levelorder = modelled_misses<Levelorder>(tree);
+		const Misses paths = modelled_path_misses(tree);
+		report_value("layout_l1_postorder," + name, "misses/node", postorder.l1_);
+		report_value("layout_tlb_postorder," + name, "misses/node", postorder.tlb_);
+		report_value("layout_l1_levelorder," + name, "misses/node", levelorder.l1_);
+		report_value("layout_tlb_levelorder," + name, "misses/node", levelorder.tlb_);
+		report_value("layout_l1_paths," + name, "misses/node", paths.l1_);
+		report_value("layout_tlb_paths," + name, "misses/node", paths.tlb_);
+	}
+}
+
+// Time building the tree, which allocates every node, then report the
+// Node_Allocator counters of the whole run.
+void
+Benchmark::allocation(void)
+{
+	Interpreter_Context context;
+	Interpreter interpreter;
+	const std::string expression = make_expression(terms_);
+
+	report("allocation,interpret", measure(warmup_, repetitions_, [&]() {
+		TREE tree = interpreter.interpret(context, expression);
+		sink = tree.is_null();
+	}), nodes_);
+
+	const Node_Allocator_Stats stats = Node_Allocator::stats();
+	report_value("allocator,node_allocations", "count", static_cast<double>(stats.allocations_));
+	report_value("allocator,large_node_allocations", "count", static_cast<double>(stats.large_));
+	report_value("allocator,immediate_nodes", "count", static_cast<double>(stats.pins_));
+	report_value("allocator,slabs_allocated", "count", static_cast<double>(stats.slabs_allocated_));
+	report_value("allocator,slabs_reused", "count", static_cast<double>(stats.slabs_reused_));
+	report_value("allocator,slabs_recycled", "count", static_cast<double>(stats.slabs_recycled_));
+	report_value("allocator,slabs_released", "count", static_cast<double>(stats.slabs_released_));
+}
+
+// Print the summary of one timed experiment: the minimum, median,
+// mean, sample standard deviation and maximum of <seconds> per item,
+// then the same for each hardware counter the measure read.
+void
+Benchmark::report(const std::string &name, const std::vector<double> &seconds, size_t items)
+{
+	const double per_item = 1.0 / (items ? items : 1);
+
+	std::vector<double> values(seconds);
+	for (size_t i = 0; i < values.size(); ++i)
+		values[i] *= 1e9 * per_item;
+	print_summary(name, "ns/item", values);
+
+	if (counters == nullptr || counted.empty())
+		return;
+
+	for (size_t e = 0; e < PERF_EVENT_COUNT; ++e) {
+		const Perf_Event event = static_cast<Perf_Event>(e);
+		if (!counters->is_open(event))
+			continue;
+
+		values.clear();
+		for (size_t i = 0; i < counted.size(); ++i)
+			values.push_back(counted[i].counts_[e] * per_item);
+		print_summary(name, std::string(Perf_Counters::name(event)) + "/item", values);
+	}
+	counted.clear();
+}
+
+// Print a single value in the same columns as report.
+void
+Benchmark::report_value(const std::string &name, const std::string &unit, double value)
+{
+	print_summary(name, unit, std::vector<double>(1, value));
+}
+
+#endif /* _Benchmark_CPP */
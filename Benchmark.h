@@ -0,0 +1,110 @@
+#pragma once
+#ifndef _Benchmark_H
+#define _Benchmark_H
+
+// This header defines "size_t"
+#include <stdlib.h>
+#include <string>
+#include <vector>
+
+#include "Tree.h"
+
+/**
+* @class Benchmark
+* @brief Runs the timing experiments selected with the -b option and
+*        prints a summary of the time per item for each of them.
+*
+*        Every experiment runs untimed a few times first, then is
+*        timed a number of times.  Each result is one comma separated
+*        line: the benchmark, its variant, the unit, the number of
+*        samples, and their minimum, median, mean, standard deviation
+*        and maximum, below a header line naming the columns.  With
+*        the -e option each timed experiment is followed by the same
+*        summary of each hardware counter per item, see Perf_Counters.
+*/
+class Benchmark
+{
+public:
+	/// Ctor - <terms> is the number of operands of the expression the
+	/// benchmarks run on, each experiment runs <warmup> times and then
+	/// is timed <repetitions> times.
+	Benchmark(size_t terms, size_t repetitions = 5, size_t warmup = 1);
+
+	/// Dtor
+	~Benchmark(void);
+
+	/// Run all the benchmarks.
+	void run(void);
+
+	/// Return a sum of <terms> operands whose parentheses nest as a
+	/// balanced tree.
+	static std::string make_expression(size_t terms);
+
+private:
+	/// Interpreter::interpret, parse and build by expression size and
+	/// shape.
+	void interpreter(void);
+
+	/// Build and evaluate trees of each shape from the
+	/// Workload_Generator.
+	void workloads(void);
+
+	/// Tree::begin traversals in each order with each queue strategy,
+	/// then seeking in the depth first orders.
+	void traversals(void);
+
+	/// Seeks to <seeks> positions in <ORDER>, named <order>, of <tree>.
+	template <typename ORDER>
+	void seek(const std::string &order, const TREE &tree, size_t seeks);
+
+	/// The Eval_Visitors and the Print_Visitor over the whole tree.
+	void visitors(void);
+
+	/// Copying, assigning and making Tree handles.
+	void refcounting(void);
+
+	/// Standard algorithms over Tree_Iterator for each traversal order.
+	void iterator_algorithms(void);
+
+	/// Breadth first traversal with each Queue strategy, one node and
+	/// one whole level per queue call.
+	void queue_strategies(void);
+
+	/// Hand trees from producer to consumer threads through an
+	/// MPMC_Queue with 1 to 32 threads on each side.
+	void queue_contention(void);
+
+	/// Traverse the tree as built and compacted in each Tree_Layout.
+	void layouts(void);
+
+	/// Time building the tree, then print the Node_Allocator counters.
+	void allocation(void);
+
+	/// Time dropping the last handle to a tree, with the nodes
+	/// destroyed inline and by the Node_Reclaimer's background thread.
+	void reclamation(void);
+
+	/// Print the summary of the <seconds> each run took, per item for
+	/// <items> items.
+	void report(const std::string &name, const std::vector<double> &seconds, size_t items);
+
+	/// Print one value measured some other way than by timing.
+	void report_value(const std::string &name, const std::string &unit, double value);
+
+	/// Number of operands in the expression.
+	size_t terms_;
+
+	/// Number of times each experiment is timed.
+	size_t repetitions_;
+
+	/// Number of untimed runs before those.
+	size_t warmup_;
+
+	/// Tree the experiments run on.
+	TREE tree_;
+
+	/// Number of nodes in <tree_>.
+	size_t nodes_;
+};
+
+#endif /* _Benchmark_H */
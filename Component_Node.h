@@ -7,10 +7,18 @@
 
 #include "Typedefs.h"
 #include "Visitor.h"
+#include "Node_Allocator.h"
+#include "Hot_Counters.h"
 
 template <typename T>
 class Refcounter;
 
+template <typename T>
+class Node_Reclaimer;
+
+template <typename T>
+class Node_Child;
+
 /**
 * @class Component_Node
 * @brief Defines the abstract base class of Composite Hierarchy.
@@ -22,6 +30,7 @@ class Component_Node
 	//Naren:TODO
 	//friend class Tree<T>;
 	friend class Refcounter<Component_Node<T> >;
+	friend class Node_Reclaimer<T>;
 
 public:
 
@@ -45,10 +54,33 @@ public:
 	/// Ctor
 	Component_Node()
 		:use_{1}
-	{}
+	{
+		HOT_COUNT(NODES_CONSTRUCTED);
+	}
 
 	/// Dtor
 	virtual ~Component_Node() {
+		HOT_COUNT(NODES_DESTROYED);
+	}
+
+	/// Nodes of every subclass are carved from the Node_Allocator's
+	/// slabs.  The destructor is virtual, so <size> is the size of the
+	/// node's own class.
+	static void *operator new(size_t size) {
+		return Node_Allocator::allocate(size);
+	}
+
+	static void operator delete(void *ptr, size_t size) {
+		Node_Allocator::deallocate(ptr, size);
+	}
+
+	/// Placement forms, used to build immediate leaves inside their
+	/// parent (see Node_Child).
+	static void *operator new(size_t, void *where) {
+		return where;
+	}
+
+	static void operator delete(void *, void *) {
 	}
 
 	/// Accept method for visitor
@@ -65,6 +97,23 @@ public:
 		throw typename Component_Node<T>::NoImplementation(errormsg);
 	}
 
+	/// Return the number of bytes relocate needs.
+	virtual size_t node_size(void) const {
+		//throw an exception if this method is called where it should not be
+		std::string errormsg = "No implementation for Component_Node<T>::node_size  ";
+		throw typename Component_Node<T>::NoImplementation(errormsg);
+	}
+
+	/// Build a copy of this node at <where>, node_size() bytes from
+	/// operator new, with <left> and <right> as its children.  Used to
+	/// compact a tree, see Tree_Compactor.
+	virtual Component_Node* relocate(void *where,
+		const Node_Child<T> &left, const Node_Child<T> &right) const {
+		//throw an exception if this method is called where it should not be
+		std::string errormsg = "No implementation for Component_Node<T>::relocate  ";
+		throw typename Component_Node<T>::NoImplementation(errormsg);
+	}
+
 	/// Return the left child.
 	virtual Component_Node* left(void) const {
 		return nullptr;
@@ -75,10 +124,18 @@ public:
 		return nullptr;
 	}
 
+	/// Return the number of nodes in the subtree under this node,
+	/// itself included.  A node without children is a subtree of one.
+	virtual size_t subtree_size(void) const {
+		return 1;
+	}
+
 private:
 
 	/// Reference counter
 	int use_;
 };
 
+#include "Node_Reclaimer.h"
+
 #endif /* _Component_Node_H */
\ No newline at end of file
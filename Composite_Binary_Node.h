@@ -15,14 +15,23 @@ template <typename T>
 class Composite_Binary_Node : public Composite_Unary_Node<T>
 {
 public:
-	/// Ctor
-	Composite_Binary_Node(Component_Node<T> *left = 0, Component_Node<T> *right = 0) 
-		:left_{ left }, Composite_Unary_Node<T>(right)
-	{}
+	/// Ctor - each child is a node to take over or an immediate leaf.
+	/// As for Composite_Unary_Node, a node with an immediate leaf must be
+	/// created with new.
+	Composite_Binary_Node(Node_Child<T> left = 0, Node_Child<T> right = 0) 
+		:left_{ left.place(left_leaf_) }, Composite_Unary_Node<T>(right)
+	{
+		if (left_.get() != nullptr)
+			this->size_ += left_->subtree_size();
+	}
 
-	/// Dtor
+	/// Dtor - drops this node's reference to the left child, see
+	/// ~Composite_Unary_Node.
 	virtual ~Composite_Binary_Node()
-	{}
+	{
+		if (left_.get() != nullptr)
+			Node_Reclaimer<T>::instance()->release(left_.release());
+	}
 
 	/// Return the left child.
 	virtual Component_Node<T>  *left(void) const {
@@ -30,6 +39,9 @@ public:
 	}
 
 protected:
+	/// Storage for an immediate left child, see Node_Child.
+	typename Node_Child<T>::Storage left_leaf_;
+
 	/// Left child.
 	std::auto_ptr< Component_Node<T> > left_;
 };
@@ -14,8 +14,9 @@ template <typename T>
 class Composite_Divide_Node : public Composite_Binary_Node<T>
 {
 public:
-	/// Ctor
-	Composite_Divide_Node(Component_Node<T> *left = 0,Component_Node<T> *right = 0)
+	/// Ctor - an immediate child needs the node created with new, see
+	/// Composite_Unary_Node.
+	Composite_Divide_Node(Node_Child<T> left = 0,Node_Child<T> right = 0)
 		: Composite_Binary_Node<T>(left, right)
 	{}
 
@@ -25,8 +26,20 @@ public:
 
 	/// Accept method for visitor
 	virtual void accept(Visitor& v) {
+		HOT_COUNT(VISITOR_VISITS);
 		v.visit(*this);
 	}
+
+	/// Return the number of bytes relocate needs.
+	virtual size_t node_size(void) const {
+		return sizeof(Composite_Divide_Node<T>);
+	}
+
+	/// Build a copy of this node at <where> with the given children.
+	virtual Component_Node<T> *relocate(void *where,
+		const Node_Child<T> &left, const Node_Child<T> &right) const {
+		return new (where) Composite_Divide_Node<T>(left, right);
+	}
 };
 
 #endif /*_Composite_Divide_Node_H*/
\ No newline at end of file
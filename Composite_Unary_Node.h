@@ -4,6 +4,7 @@
 
 #include <memory>
 #include "Component_Node.h"
+#include "Node_Child.h"
 
 /**
 * @class Composite_Unary_Node
@@ -13,24 +14,48 @@ template <typename T>
 class Composite_Unary_Node : public Component_Node<T>
 {
 public:
-	/// Ctor
-	Composite_Unary_Node(Component_Node<T> *right = 0)
-		:right_{right}
+	/// Ctor - <right> is a node to take over or an immediate leaf.  An
+	/// immediate leaf pins this node's slab, so the node must then be
+	/// created with new, not on the stack, placed in other memory or
+	/// above Node_Allocator::MAX_SIZE; see Node_Allocator::pin.
+	Composite_Unary_Node(Node_Child<T> right = 0)
+		:right_{right.place(right_leaf_)},
+		size_{ 1 + (right_.get() != nullptr ? right_->subtree_size() : 0) }
 	{}
 
-	/// Dtor
+	/// Dtor - drops this node's reference to the child.  The
+	/// Node_Reclaimer deletes it once unused, iteratively, so the
+	/// auto_ptr never deletes a subtree recursively.
 	virtual ~Composite_Unary_Node() 
-	{}
+	{
+		if (right_.get() != nullptr)
+			Node_Reclaimer<T>::instance()->release(right_.release());
+	}
 
 	/// Return the right child.
 	virtual Component_Node<T>  *right(void) const {
 		return right_.get();
 	}
 
+	/// Return the number of nodes under this one and itself, counted
+	/// when it was built.  The children are built first and do not
+	/// change after, so the count stays right.
+	virtual size_t subtree_size(void) const {
+		return size_;
+	}
+
 protected:
 
+	/// Storage for an immediate right child, see Node_Child.  Declared
+	/// before <right_> since <right_> may be built in it.
+	typename Node_Child<T>::Storage right_leaf_;
+
 	/// Right child.
 	std::auto_ptr< Component_Node<T> > right_;
+
+	/// Nodes in the subtree, see subtree_size.  Composite_Binary_Node
+	/// adds the left child's.
+	size_t size_;
 };
 
 #endif /*_Composite_Unary_Node_H*/
\ No newline at end of file
@@ -2,8 +2,10 @@
 #ifndef _Eval_Visitor_H
 #define _Eval_Visitor_H
 
-#include <stack>
+#include <string>
+
 #include "Visitor.h"
+#include "Inline_Stack.h"
 #include "Typedefs.h"
 #include "Component_Node.h"
 #include "Leaf_Node.h"
@@ -18,17 +20,46 @@
 * @class Post_Order_Eval_Visitor is a subclass of Visitor
 * @brief Defines a Expression Evaluator - evaluates the expression represented
 by a tree in post order.
+
+The operands are kept on an Inline_Stack, which holds as many as a
+tree of its inline capacity in height needs without allocating.  For
+a taller tree, construct the visitor with the tree: the operand stack
+never holds more than the tree's height, so it is sized from the
+Tree_Stats once and does not grow during the evaluation.
+
+A division by 0 throws Division_By_Zero instead of faulting, wherever
+in the tree it happens, e.g. 5/(2-2).
 */
 
 template <typename T>
 class Post_Order_Eval_Visitor : public Visitor
 {
 public:
+	/// Division_By_Zero class for exceptions when a divisor evaluates
+	/// to 0
+	class Division_By_Zero
+	{
+	public:
+		const std::string what(void) const
+		{
+			return "division by zero";
+		}
+	};
+
 	///Ctor
 	Post_Order_Eval_Visitor(void)
 		:stack_()
 	{}
 
+	///Ctor - sizes the stack for evaluating <tree>, if its Tree_Stats
+	///are kept with it.
+	explicit Post_Order_Eval_Visitor(const Tree<T> &tree)
+		:stack_()
+	{
+		if (tree.has_stats())
+			stack_.reserve(tree.stats().height_);
+	}
+
 	///Dtor
 	virtual ~Post_Order_Eval_Visitor(void){}
 
@@ -85,7 +116,7 @@ public:
 		T leftOperand = stack_.top();
 		stack_.pop();
 
-		stack_.push(leftOperand / rightOperand);
+		stack_.push(divide(leftOperand, rightOperand));
 	}
 
 	T yield() {
@@ -93,7 +124,15 @@ public:
 	}
 
 protected:
-	std::stack<T> stack_;
+	/// Returns <leftOperand> / <rightOperand>, throws Division_By_Zero
+	/// if <rightOperand> is 0.
+	static T divide(const T &leftOperand, const T &rightOperand) {
+		if (rightOperand == T())
+			throw Division_By_Zero();
+		return leftOperand / rightOperand;
+	}
+
+	Inline_Stack<T> stack_;
 };
 
 /**
@@ -111,10 +150,20 @@ public:
 	Pre_Order_Eval_Visitor(void)
 	{}
 
+	///Ctor - sizes the stack for evaluating <tree>, see
+	///Post_Order_Eval_Visitor.
+	explicit Pre_Order_Eval_Visitor(const Tree<T> &tree)
+		:Post_Order_Eval_Visitor<T>(tree)
+	{}
+
 	///Dtor
 	virtual ~Pre_Order_Eval_Visitor(void)
 	{}
 
+	// The visit methods for the other nodes are the same as in post
+	// order, and can be called as this class's too.
+	using Post_Order_Eval_Visitor<T>::visit;
+
 	/// Visit method for COMPOSITE_SUBTRACT_NODE instances
 	virtual void visit(const COMPOSITE_SUBTRACT_NODE& node) {
 		T leftOperand = stack_.top();
@@ -134,7 +183,7 @@ public:
 		T rightOperand = stack_.top();
 		stack_.pop();
 
-		stack_.push(leftOperand / rightOperand);
+		stack_.push(this->divide(leftOperand, rightOperand));
 	}
 };
 
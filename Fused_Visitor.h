@@ -0,0 +1,120 @@
+#pragma once
+#ifndef _Fused_Visitor_H
+#define _Fused_Visitor_H
+
+#include "Visitor.h"
+#include "Typedefs.h"
+
+/**
+* @class Visitor_List
+* @brief The visitors a Fused_Visitor forwards to, the first of them
+*        and a Visitor_List of the rest.  Each one is called through a
+*        reference of its own type, so an overriding visit method of
+*        the object it is bound to still runs.
+*/
+template <typename... VISITORS>
+class Visitor_List;
+
+template <>
+class Visitor_List<>
+{
+public:
+	/// Nothing left to forward to.
+	template <typename NODE>
+	void visit(const NODE &) {}
+};
+
+template <typename VISITOR, typename... REST>
+class Visitor_List<VISITOR, REST...>
+{
+public:
+	/// Ctor
+	Visitor_List(VISITOR &first, REST &... rest)
+		:first_(first), rest_(rest...)
+	{}
+
+	/// Hand <node> to the first visitor, then to the rest.
+	template <typename NODE>
+	void visit(const NODE &node) {
+		first_.visit(node);
+		rest_.visit(node);
+	}
+
+private:
+	/// Visitor the node is handed to first.
+	VISITOR &first_;
+
+	/// Visitors it is handed to after it.
+	Visitor_List<REST...> rest_;
+};
+
+/**
+* @class Fused_Visitor is a subclass of Visitor
+* @brief Hands each node it visits to every one of <VISITORS> in turn,
+*        so one traversal does the work of one per visitor, e.g.
+*
+*        Fused_Visitor<Post_Order_Eval_Visitor<int>, Print_Visitor>
+*            both(eval_visitor, print_visitor);
+*        for (...tree.begin<Postorder>()...) it.get_node()->accept(both);
+*
+*        The visitors must agree on the order they are walked in.  The
+*        calls to the visitors are virtual, as through Visitor, so a
+*        visitor bound to a reference of its base class behaves as it
+*        would on its own; the compiler can only call a visitor
+*        directly, and inline it, where its type is final.  The
+*        visitors are held by reference and must outlive the
+*        Fused_Visitor.
+*/
+template <typename... VISITORS>
+class Fused_Visitor : public Visitor
+{
+public:
+	/// Ctor
+	explicit Fused_Visitor(VISITORS &... visitors)
+		:visitors_(visitors...)
+	{}
+
+	/// Visit method for LEAF_NODE instances
+	virtual void visit(const LEAF_NODE& node) {
+		visitors_.visit(node);
+	}
+
+	/// Visit method for COMPOSITE_NEGATE_NODE instances
+	virtual void visit(const COMPOSITE_NEGATE_NODE& node) {
+		visitors_.visit(node);
+	}
+
+	/// Visit method for COMPOSITE_ADD_NODE instances
+	virtual void visit(const COMPOSITE_ADD_NODE& node) {
+		visitors_.visit(node);
+	}
+
+	/// Visit method for COMPOSITE_SUBTRACT_NODE instances
+	virtual void visit(const COMPOSITE_SUBTRACT_NODE& node) {
+		visitors_.visit(node);
+	}
+
+	/// Visit method for COMPOSITE_MULTIPLY_NODE instances
+	virtual void visit(const COMPOSITE_MULTIPLY_NODE& node) {
+		visitors_.visit(node);
+	}
+
+	/// Visit method for COMPOSITE_DIVIDE_NODE instances
+	virtual void visit(const COMPOSITE_DIVIDE_NODE& node) {
+		visitors_.visit(node);
+	}
+
+private:
+	/// The visitors each node is handed to.
+	Visitor_List<VISITORS...> visitors_;
+};
+
+/// Returns a Fused_Visitor over <visitors>, so their types need not be
+/// spelled out.
+template <typename... VISITORS>
+Fused_Visitor<VISITORS...> make_fused_visitor(VISITORS &... visitors)
+{
+	return Fused_Visitor<VISITORS...>(visitors...);
+}
+
+#endif /* _Fused_Visitor_H */
@@ -0,0 +1,127 @@
+#include "stdafx.h"
+#if !defined (_Hot_Counters_CPP)
+#define _Hot_Counters_CPP
+
+#include <mutex>
+#include <iomanip>
+#include "Hot_Counters.h"
+
+namespace
+{
+	/// Names of the counters in <Hot_Counter> order.
+	const char *counter_names[HOT_COUNTER_COUNT] = {
+		"refcount_increments",
+		"refcount_decrements",
+		"nodes_constructed",
+		"nodes_destroyed",
+		"queue_enqueues",
+		"queue_dequeues",
+		"visitor_visits",
+		"interpreter_tokens",
+		"expressions_parsed"
+	};
+}
+
+// The running threads' counts and the totals of the exited ones.
+struct Hot_Counters::Registry
+{
+	Registry(void)
+		:running_{ nullptr }
+	{
+		for (size_t i = 0; i < HOT_COUNTER_COUNT; ++i)
+			exited_[i] = 0;
+	}
+
+	std::mutex lock_;
+	// Serializes threads starting, exiting and being read.
+
+	Thread_Counts *running_;
+	// Counts of the running threads, linked through <next_>.
+
+	size_t exited_[HOT_COUNTER_COUNT];
+	// Totals of the threads that have exited.
+};
+
+/* statics of the counters */
+thread_local Hot_Counters::Thread_Counts Hot_Counters::counts_;
+
+// Returns the one and only registry.  It is never deleted, threads may
+// exit during static destruction.
+Hot_Counters::Registry *
+Hot_Counters::registry(void)
+{
+	static Registry *registry = new Registry;
+	return registry;
+}
+
+// Register the calling thread's counts.
+Hot_Counters::Thread_Counts::Thread_Counts(void)
+{
+	for (size_t i = 0; i < HOT_COUNTER_COUNT; ++i)
+		counts_[i].store(0, std::memory_order_relaxed);
+
+	std::lock_guard<std::mutex> guard(registry()->lock_);
+	next_ = registry()->running_;
+	registry()->running_ = this;
+}
+
+// Keep the counts of an exiting thread.
+Hot_Counters::Thread_Counts::~Thread_Counts(void)
+{
+	std::lock_guard<std::mutex> guard(registry()->lock_);
+	for (size_t i = 0; i < HOT_COUNTER_COUNT; ++i)
+		registry()->exited_[i] += counts_[i].load(std::memory_order_relaxed);
+
+	Thread_Counts **link = &registry()->running_;
+	while (*link != this)
+		link = &(*link)->next_;
+	*link = next_;
+}
+
+// Returns <counter> summed over all threads.
+size_t
+Hot_Counters::total(Hot_Counter counter)
+{
+	std::lock_guard<std::mutex> guard(registry()->lock_);
+	size_t total = registry()->exited_[counter];
+	for (Thread_Counts *counts = registry()->running_; counts != nullptr; counts = counts->next_)
+		total += counts->counts_[counter].load(std::memory_order_relaxed);
+	return total;
+}
+
+// Returns the name <counter> is printed under.
+const char *
+Hot_Counters::name(Hot_Counter counter)
+{
+	return counter_names[counter];
+}
+
+// Print the counters one per line.
+void
+Hot_Counters::print(std::ostream &output)
+{
+#if defined (HOT_PATH_COUNTERS)
+	const size_t expressions = total(EXPRESSIONS_PARSED);
+
+	output << "counter,total,per_expression" << std::endl;
+	for (size_t i = 0; i < HOT_COUNTER_COUNT; ++i) {
+		const size_t count = total(static_cast<Hot_Counter>(i));
+		output << counter_names[i] << "," << count << ",";
+		if (expressions != 0)
+			output << std::fixed << std::setprecision(2)
+				<< static_cast<double>(count) / expressions;
+		output << std::endl;
+	}
+#else
+	output << "hot path counters are compiled out, build with HOT_PATH_COUNTERS" << std::endl;
+#endif
+}
+
+// Print to std::cout.
+void
+Hot_Counters::print_at_exit(void)
+{
+	print(std::cout);
+}
+
+#endif /* _Hot_Counters_CPP */
@@ -0,0 +1,111 @@
+#pragma once
+#ifndef _Hot_Counters_H
+#define _Hot_Counters_H
+
+// This header defines "size_t"
+#include <stdlib.h>
+#include <iostream>
+#include <atomic>
+
+/// Operations counted on the hot paths.
+enum Hot_Counter
+{
+	REFCOUNT_INCREMENTS,
+	// Refcounter::increment on a non null pointer.
+
+	REFCOUNT_DECREMENTS,
+	// Refcounter::decrement on a non null pointer.
+
+	NODES_CONSTRUCTED,
+	// Component_Node constructors, immediate leaves included.
+
+	NODES_DESTROYED,
+	// Component_Node destructors.
+
+	QUEUE_ENQUEUES,
+	// Items enqueued on a Queue or MPMC_Queue.
+
+	QUEUE_DEQUEUES,
+	// Items dequeued from a Queue or MPMC_Queue.
+
+	VISITOR_VISITS,
+	// Calls of accept, each one dispatching to a Visitor::visit.
+
+	INTERPRETER_TOKENS,
+	// Numbers, variables, operators and parentheses the Interpreter
+	// handled.
+
+	EXPRESSIONS_PARSED,
+	// Calls of Interpreter::parse.
+
+	HOT_COUNTER_COUNT
+};
+
+/// Count one <counter> operation.  Compiles to nothing unless
+/// HOT_PATH_COUNTERS is defined, see stdafx.h.
+#if defined (HOT_PATH_COUNTERS)
+#define HOT_COUNT(counter) Hot_Counters::add(counter, 1)
+#define HOT_COUNT_N(counter, n) Hot_Counters::add(counter, n)
+#else
+#define HOT_COUNT(counter) ((void) 0)
+#define HOT_COUNT_N(counter, n) ((void) 0)
+#endif
+
+/**
+* @class Hot_Counters
+* @brief Per thread counts of the operations in <Hot_Counter>.
+*
+*        Each thread adds to its own counts without synchronization,
+*        the atomics are only there so they can be read while it runs.
+*        A thread that exits adds its counts to the totals of the
+*        threads that have exited.  The counts are only kept when the
+*        program is built with HOT_PATH_COUNTERS, otherwise HOT_COUNT
+*        leaves no code behind.
+*/
+class Hot_Counters
+{
+public:
+	/// Add <n> to the calling thread's <counter>.
+	static void add(Hot_Counter counter, size_t n) {
+		std::atomic<size_t> &count = counts_.counts_[counter];
+		count.store(count.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+	}
+
+	/// Returns <counter> summed over all threads, running or exited.
+	static size_t total(Hot_Counter counter);
+
+	/// Returns the name <counter> is printed under.
+	static const char *name(Hot_Counter counter);
+
+	/// Print one "name,total,per_expression" line per counter, the per
+	/// expression figure taken over EXPRESSIONS_PARSED.
+	static void print(std::ostream &output);
+
+	/// Print to std::cout, for use with atexit.
+	static void print_at_exit(void);
+
+private:
+	/// The calling thread's counts, registered while the thread runs.
+	class Thread_Counts
+	{
+	public:
+		Thread_Counts(void);
+		~Thread_Counts(void);
+
+		std::atomic<size_t> counts_[HOT_COUNTER_COUNT];
+
+		Thread_Counts *next_;
+		// Next running thread's counts.
+	};
+
+	/// The running threads' counts and the totals of the exited ones.
+	struct Registry;
+
+	static Registry *registry(void);
+	// Returns the one and only registry.
+
+	static thread_local Thread_Counts counts_;
+	// The calling thread's counts.
+};
+
+#endif /* _Hot_Counters_H */
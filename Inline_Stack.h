@@ -0,0 +1,219 @@
+#pragma once
+#ifndef _Inline_Stack_H
+#define _Inline_Stack_H
+
+// This header defines "size_t"
+#include <stdlib.h>
+
+/**
+* @class Inline_Stack
+* @brief Defines a LIFO stack that keeps its first <N> elements in an
+*        array embedded in the object and only goes to the free store
+*        once more than <N> elements are pushed.
+*
+*        Used by the iterators to hold their traversal state, so
+*        walking a small tree never allocates.  <E> is expected to be
+*        a cheap to copy type such as a node pointer.
+*/
+template <typename E, size_t N = 32>
+class Inline_Stack
+{
+public:
+	/// Default ctor
+	Inline_Stack(void)
+		:data_{ inline_ }, size_{ 0 }, capacity_{ N }
+	{}
+
+	/// Copy ctor
+	Inline_Stack(const Inline_Stack<E, N> &rhs)
+		:data_{ inline_ }, size_{ 0 }, capacity_{ N }
+	{
+		reserve(rhs.size_);
+		for (size_t i = 0; i < rhs.size_; ++i)
+			data_[i] = rhs.data_[i];
+		size_ = rhs.size_;
+	}
+
+	/// Assignment operator
+	Inline_Stack<E, N> &operator= (const Inline_Stack<E, N> &rhs) {
+		if (this != &rhs) {
+			size_ = 0;
+			reserve(rhs.size_);
+			for (size_t i = 0; i < rhs.size_; ++i)
+				data_[i] = rhs.data_[i];
+			size_ = rhs.size_;
+		}
+		return *this;
+	}
+
+	/// Dtor - only the spilled buffer lives on the free store.
+	~Inline_Stack(void) {
+		if (data_ != inline_)
+			delete[] data_;
+	}
+
+	/// Place <item> on the top of the stack.
+	void push(const E &item) {
+		if (size_ == capacity_)
+			reserve(capacity_ * 2);
+		data_[size_++] = item;
+	}
+
+	/// Remove the top item.  The stack must not be empty.
+	void pop(void) {
+		--size_;
+	}
+
+	/// Return the top item.  The stack must not be empty.
+	E &top(void) {
+		return data_[size_ - 1];
+	}
+
+	const E &top(void) const {
+		return data_[size_ - 1];
+	}
+
+	bool empty(void) const {
+		return size_ == 0;
+	}
+
+	size_t size(void) const {
+		return size_;
+	}
+
+	/// Remove every item, keeping the storage.
+	void clear(void) {
+		size_ = 0;
+	}
+
+	/// Make room for at least <n> elements without further allocation.
+	void reserve(size_t n) {
+		if (n <= capacity_)
+			return;
+		E *temp = new E[n];
+		for (size_t i = 0; i < size_; ++i)
+			temp[i] = data_[i];
+		if (data_ != inline_)
+			delete[] data_;
+		data_ = temp;
+		capacity_ = n;
+	}
+
+private:
+	/// Storage used until the stack outgrows <N> elements.
+	E inline_[N];
+
+	/// Points either at <inline_> or at a buffer from the free store.
+	E *data_;
+
+	size_t size_;
+	size_t capacity_;
+};
+
+/**
+* @class Inline_Queue
+* @brief Defines a FIFO ring buffer that keeps its first <N> elements in
+*        an array embedded in the object, doubling onto the free store
+*        when it fills up.  <N> must be a power of two.
+*/
+template <typename E, size_t N = 32>
+class Inline_Queue
+{
+public:
+	/// Default ctor
+	Inline_Queue(void)
+		:data_{ inline_ }, head_{ 0 }, size_{ 0 }, capacity_{ N }
+	{}
+
+	/// Copy ctor
+	Inline_Queue(const Inline_Queue<E, N> &rhs)
+		:data_{ inline_ }, head_{ 0 }, size_{ 0 }, capacity_{ N }
+	{
+		copy(rhs);
+	}
+
+	/// Assignment operator
+	Inline_Queue<E, N> &operator= (const Inline_Queue<E, N> &rhs) {
+		if (this != &rhs) {
+			head_ = 0;
+			size_ = 0;
+			copy(rhs);
+		}
+		return *this;
+	}
+
+	/// Dtor
+	~Inline_Queue(void) {
+		if (data_ != inline_)
+			delete[] data_;
+	}
+
+	/// Place <item> at the tail of the queue.
+	void enqueue(const E &item) {
+		if (size_ == capacity_)
+			grow(capacity_ * 2);
+		data_[(head_ + size_) & (capacity_ - 1)] = item;
+		++size_;
+	}
+
+	/// Remove the front item.  The queue must not be empty.
+	void dequeue(void) {
+		head_ = (head_ + 1) & (capacity_ - 1);
+		--size_;
+	}
+
+	/// Return the front item.  The queue must not be empty.
+	const E &front(void) const {
+		return data_[head_];
+	}
+
+	bool empty(void) const {
+		return size_ == 0;
+	}
+
+	size_t size(void) const {
+		return size_;
+	}
+
+	/// Make room for at least <n> elements without further allocation.
+	void reserve(size_t n) {
+		size_t capacity = capacity_;
+		while (capacity < n)
+			capacity *= 2;
+		grow(capacity);
+	}
+
+private:
+	void copy(const Inline_Queue<E, N> &rhs) {
+		size_t capacity = capacity_;
+		while (capacity < rhs.size_)
+			capacity *= 2;
+		grow(capacity);
+		for (size_t i = 0; i < rhs.size_; ++i)
+			data_[i] = rhs.data_[(rhs.head_ + i) & (rhs.capacity_ - 1)];
+		head_ = 0;
+		size_ = rhs.size_;
+	}
+
+	/// Move the elements into a buffer of <n> slots, unwrapping the ring.
+	void grow(size_t n) {
+		if (n <= capacity_)
+			return;
+		E *temp = new E[n];
+		for (size_t i = 0; i < size_; ++i)
+			temp[i] = data_[(head_ + i) & (capacity_ - 1)];
+		if (data_ != inline_)
+			delete[] data_;
+		data_ = temp;
+		head_ = 0;
+		capacity_ = n;
+	}
+
+	E inline_[N];
+	E *data_;
+	size_t head_;
+	size_t size_;
+	size_t capacity_;
+};
+
+#endif /* _Inline_Stack_H */
@@ -12,6 +12,9 @@
 #include "Composite_Subtract_Node.h"
 #include "Composite_Divide_Node.h"
 #include "Composite_Multiply_Node.h"
+#include "Hot_Counters.h"
+#include "Phase_Tracer.h"
+#include "Latency_Histogram.h"
 
 /**
 * @class Symbol
@@ -39,6 +42,13 @@ public:
 
 	virtual Component_Node<int> *build(void) = 0;
 
+	/// method for building a node as the child of an operator's node.
+	/// Numbers build an immediate leaf inside the parent instead.
+	virtual Node_Child<int> build_child(void)
+	{
+		return build();
+	}
+
 	/// left and right pointers
 
 	Symbol *left_;
@@ -86,7 +96,7 @@ class Number : public Symbol
 public:
 	/// constructors
 	Number(std::string input);
-	Number(int input);
+	Number(int input, int variable = 0);
 
 	/// destructor
 	virtual ~Number(void);
@@ -97,9 +107,15 @@ public:
 
 	/// builds an equivalent expression tree node
 	virtual Component_Node<int> *build(void);
+
+	/// builds an immediate leaf for the parent's node
+	virtual Node_Child<int> build_child(void);
 private:
 	/// contains the value of the leaf node
 	int item_;
+
+	/// id of the variable <item_> is the value of, 0 for a number
+	int variable_;
 };
 
 /**
@@ -253,6 +269,16 @@ Interpreter_Context::reset(void)
 	map_.clear();
 }
 
+// return the id of a variable, giving it the next one if it has none
+int
+Interpreter_Context::variable_id(const std::string &variable)
+{
+	std::map<std::string, int>::iterator i = ids_.find(variable);
+	if (i == ids_.end())
+		i = ids_.insert(std::make_pair(variable, static_cast<int>(ids_.size()) + 1)).first;
+	return i->second;
+}
+
 // constructor
 Symbol::Symbol(Symbol *left, Symbol *right, int precedence)
 	: left_(left), right_(right), precedence_(precedence)
@@ -290,15 +316,17 @@ Unary_Operator::~Unary_Operator(void)
 
 // constructor
 Number::Number(std::string input)
-	: Symbol(0, 0, 4)
+	: Symbol(0, 0, 4),
+	variable_(0)
 {
 	item_ = atoi(input.c_str());
 }
 
 // constructor
-Number::Number(int input)
+Number::Number(int input, int variable)
 	: Symbol(0, 0, 4),
-	item_(input)
+	item_(input),
+	variable_(variable)
 {
 }
 
@@ -318,7 +346,14 @@ Number::add_precedence(int precedence)
 Component_Node<int> *
 Number::build(void)
 {
-	return new LEAF_NODE(item_);
+	return new LEAF_NODE(item_, variable_);
+}
+
+// builds an immediate leaf, stored inside the parent's node
+Node_Child<int>
+Number::build_child(void)
+{
+	return Node_Child<int>::immediate(item_, variable_);
 }
 
 // constructor
@@ -343,7 +378,7 @@ Negate::add_precedence(int precedence)
 Component_Node<int> *
 Negate::build()
 {
-	return new COMPOSITE_NEGATE_NODE(right_->build());
+	return new COMPOSITE_NEGATE_NODE(right_->build_child());
 }
 
 // constructor
@@ -368,7 +403,7 @@ Add::add_precedence(int precedence)
 Component_Node<int> *
 Add::build(void)
 {
-	return new COMPOSITE_ADD_NODE(left_->build(), right_->build());
+	return new COMPOSITE_ADD_NODE(left_->build_child(), right_->build_child());
 }
 
 // constructor
@@ -393,7 +428,7 @@ Subtract::add_precedence(int precedence)
 Component_Node<int> *
 Subtract::build(void)
 {
-	return new COMPOSITE_SUBTRACT_NODE(left_->build(), right_->build());
+	return new COMPOSITE_SUBTRACT_NODE(left_->build_child(), right_->build_child());
 }
 
 // constructor
@@ -418,7 +453,7 @@ Multiply::add_precedence(int precedence)
 Component_Node<int> *
 Multiply::build(void)
 {
-	return new COMPOSITE_MULTIPLY_NODE(left_->build(), right_->build());
+	return new COMPOSITE_MULTIPLY_NODE(left_->build_child(), right_->build_child());
 }
 
 // constructor
@@ -443,7 +478,7 @@ Divide::add_precedence(int precedence)
 Component_Node<int> *
 Divide::build(void)
 {
-	return new COMPOSITE_DIVIDE_NODE(left_->build(), right_->build());
+	return new COMPOSITE_DIVIDE_NODE(left_->build_child(), right_->build_child());
 }
 
 // constructor
@@ -531,11 +566,13 @@ Interpreter::variable_insert(Interpreter_Context &context,
 
 	// lookup the variable in the context
 
-	int value = context.get(input.substr(i, j));
+	const std::string variable = input.substr(i, j);
+	int value = context.get(variable);
 
-	// make a Number out of the integer
+	// make a Number out of the integer, remembering which variable
+	// it came from
 
-	Number *number = new Number(value);
+	Number *number = new Number(value, context.variable_id(variable));
 	number->add_precedence(accumulated_precedence);
 
 	lastValidInput = number;
@@ -583,6 +620,8 @@ void
 Interpreter::precedence_insert(Symbol *op,
 	std::list<Symbol *>& list)
 {
+	Trace_Span span("precedence_insert");
+
 	if (!list.empty())
 	{
 		// if last element was a number, then make that our left_
@@ -748,6 +787,9 @@ Interpreter::main_loop(Interpreter_Context & context,
 		handled = true;
 		// skip whitespace
 	}
+
+	if (handled && input[i] != ' ' && input[i] != '\n')
+		HOT_COUNT(INTERPRETER_TOKENS);
 }
 
 void
@@ -821,6 +863,18 @@ Interpreter::handle_parenthesis(Interpreter_Context & context,
 TREE
 Interpreter::interpret(Interpreter_Context &context,
 	const std::string &input)
+{
+	Trace_Span span("interpret");
+	Symbol *root = parse(context, input);
+	TREE tree = build(root);
+	release(root);
+	return tree;
+}
+
+// converts a string and context into a parse tree and returns its root
+Symbol *
+Interpreter::parse(Interpreter_Context &context,
+	const std::string &input)
 {
 	std::list<Symbol *> list;
 	//list.clear ();
@@ -828,6 +882,12 @@ Interpreter::interpret(Interpreter_Context &context,
 	bool handled = false;
 	int accumulated_precedence = 0;
 
+	// The input is lexed and inserted in one pass, so the lexing time
+	// is this span less its precedence_insert spans.
+	Trace_Span span("parse");
+	Latency_Span latency(PARSE_LATENCY);
+	HOT_COUNT(EXPRESSIONS_PARSED);
+
 	for (std::string::size_type i = 0;
 		i < input.length(); ++i)
 	{
@@ -840,20 +900,39 @@ Interpreter::interpret(Interpreter_Context &context,
 		// lastValidInput = input[i];
 	}
 
-	// if the list has an element in it, then return the back of the list.
+	// if the list has an element in it, then the back of the list is
+	// the root of the parse tree.
 	if (!list.empty())
-	{
-		// Invoke a recursive Expression_Tree build starting with the root
-		// symbol. This is an example of the builder pattern. See pg 97
-		// in GoF book.
-
-		TREE tree = TREE(list.back()->build());
-		delete list.back();
-		return tree;
-	}
+		return list.back();
 
 	// If we reach this, we didn't have any symbols.
-	return TREE();
+	return 0;
+}
+
+// builds an expression tree out of the parse tree at root
+TREE
+Interpreter::build(Symbol *root)
+{
+	// Invoke a recursive Expression_Tree build starting with the root
+	// symbol. This is an example of the builder pattern. See pg 97
+	// in GoF book.
+	Trace_Span span("build");
+	Latency_Span latency(BUILD_LATENCY);
+	if (root == 0)
+		return TREE();
+
+	// Keep the statistics with the tree, for the traversals to size
+	// their stacks from.
+	TREE tree(root->build());
+	tree.stats();
+	return tree;
+}
+
+// deletes the parse tree at root
+void
+Interpreter::release(Symbol *root)
+{
+	delete root;
 }
 
 #endif // _INTERPRETER_CPP_
\ No newline at end of file
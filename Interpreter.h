@@ -39,9 +39,17 @@ public:
 	/// Clear all variables and their values.
 	void reset(void);
 
+	/// Return the id of a variable, given to it the first time it is
+	/// asked for and kept across reset.  Ids start at 1, so the leaves
+	/// of numbers can keep 0.
+	int variable_id(const std::string &variable);
+
 private:
 	/// Hash table containing variable names and values.
 	std::map<std::string, int> map_;
+
+	/// Hash table containing variable names and ids.
+	std::map<std::string, int> ids_;
 };
 
 /**
@@ -67,6 +75,19 @@ public:
 	Tree<int> interpret(Interpreter_Context &context,
 		const std::string &input);
 
+	/// Converts a string and context into a parse tree and returns its
+	/// root, or 0 if the string holds no symbols.  The caller frees it
+	/// with release.  interpret is parse, build and release in one.
+	Symbol *parse(Interpreter_Context &context,
+		const std::string &input);
+
+	/// Builds an expression tree out of the parse tree at <root>, with
+	/// its Tree_Stats kept with it.
+	static Tree<int> build(Symbol *root);
+
+	/// Deletes the parse tree at <root>.
+	static void release(Symbol *root);
+
 	/// Method for checking if a character is a valid operator.
 	static bool is_operator(char input);
 
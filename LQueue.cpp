@@ -3,63 +3,207 @@
 #define _LQUEUE_CPP
 
 
+#include <new>
 #include <functional>
 #include <algorithm>
 #include "LQueue.h"
 #include <iterator>
-/* static needs t*/
-template <typename T> LQueue_Node<T> *
-LQueue_Node<T>::free_list_ = nullptr;
+/* statics of the node pools */
+template <typename T> thread_local typename LQueue_Node<T>::Free_List
+LQueue_Node<T>::free_list_;
 
-// Allocate a new <LQueue_Node>, trying first from the
-// <free_list_> and if that's empty try from the global <::operator new>.
+template <typename T> std::atomic<uint64_t>
+LQueue_Node<T>::overflow_{ 0 };
+
+template <typename T> Atomic_Free_List_Stats
+LQueue_Node<T>::retired_stats_;
+
+template <typename T>
+LQueue_Node<T>::Free_List::Free_List(void)
+	:head_{ nullptr }, count_{ 0 }, stats_()
+{
+}
+
+// Hand the nodes of an exiting thread to the shared pool so other
+// threads can reuse them, and keep its counters.
+template <typename T>
+LQueue_Node<T>::Free_List::~Free_List(void)
+{
+	if (head_ != nullptr)
+		overflow_push(head_, count_);
+	retired_stats_.hits_ += stats_.hits_;
+	retired_stats_.refills_ += stats_.refills_;
+	retired_stats_.misses_ += stats_.misses_;
+	retired_stats_.spills_ += stats_.spills_;
+}
+
+// Returns the top of <overflow_> for <batch> with <tag>, the tag
+// wrapping around in the bits above the address.
+template <typename T> uint64_t
+LQueue_Node<T>::tagged(Batch *batch, uint64_t tag)
+{
+	const uint64_t address = static_cast<uint64_t>(reinterpret_cast<uintptr_t>(batch));
+	return (address & ((uint64_t(1) << TAG_SHIFT) - 1)) | (tag << TAG_SHIFT);
+}
+
+// Returns the batch of the top of <overflow_>.
+template <typename T> typename LQueue_Node<T>::Batch *
+LQueue_Node<T>::batch_of(uint64_t top)
+{
+	return reinterpret_cast<Batch *>(
+		static_cast<uintptr_t>(top & ((uint64_t(1) << TAG_SHIFT) - 1)));
+}
+
+// Push the <count> nodes linked from <head> onto <overflow_> as one
+// batch, kept in <head>'s memory.
+template <typename T> void
+LQueue_Node<T>::overflow_push(LQueue_Node<T> *head, size_t count)
+{
+	static_assert(sizeof(Batch) <= sizeof(LQueue_Node<T>),
+		"a batch is kept in the memory of a node");
+	LQueue_Node<T> *nodes = head->next_;
+	Batch *batch = new (static_cast<void *>(head)) Batch;
+	batch->nodes_ = nodes;
+	batch->count_ = count;
+
+	uint64_t top = overflow_.load(std::memory_order_relaxed);
+	do {
+		batch->next_ = batch_of(top);
+	} while (!overflow_.compare_exchange_weak(top,
+		tagged(batch, (top >> TAG_SHIFT) + 1),
+		std::memory_order_release,
+		std::memory_order_relaxed));
+}
+
+// Pop the top batch of <overflow_> and make it <free_list>, which must
+// be empty.  A batch is never freed while threads use the pool, so
+// reading the <next_> of one another thread has popped is harmless: the
+// tag has changed and the compare-and-swap fails.
+template <typename T> void
+LQueue_Node<T>::refill(Free_List &free_list)
+{
+	uint64_t top = overflow_.load(std::memory_order_acquire);
+	Batch *batch;
+	do {
+		batch = batch_of(top);
+		if (batch == nullptr)
+			return;
+	} while (!overflow_.compare_exchange_weak(top,
+		tagged(batch->next_, (top >> TAG_SHIFT) + 1),
+		std::memory_order_acquire,
+		std::memory_order_acquire));
+
+	LQueue_Node<T> *nodes = batch->nodes_;
+	const size_t count = batch->count_;
+	LQueue_Node<T> *head = reinterpret_cast<LQueue_Node<T> *>(batch);
+	head->next_ = nodes;
+	free_list.head_ = head;
+	free_list.count_ = count;
+}
+
+// Allocate a new <LQueue_Node>, trying first from the calling thread's
+// <free_list_>, then from <overflow_> and if that's empty try from the
+// global <::operator new>.
 template <typename T> void *
-LQueue_Node<T>::operator new (size_t)
+LQueue_Node<T>::operator new (size_t size)
 {
-	if (free_list_ != nullptr) {
-		LQueue_Node<T>* temp = free_list_;
-		free_list_ = free_list_->next_;
-		return temp;
-	}else{
-		return ::new LQueue_Node<T>();
+	Free_List &free_list = free_list_;
+	if (free_list.head_ != nullptr)
+		++free_list.stats_.hits_;
+	else {
+		refill(free_list);
+		if (free_list.head_ == nullptr) {
+			++free_list.stats_.misses_;
+			return ::operator new(size);
+		}
+		++free_list.stats_.refills_;
 	}
+
+	LQueue_Node<T>* temp = free_list.head_;
+	free_list.head_ = temp->next_;
+	--free_list.count_;
+	return temp;
 }
 
-// Return <ptr> to the <free_list_>.
+// Return <ptr> to the calling thread's <free_list_>.  If the thread
+// already caches <FREE_LIST_BOUND> nodes, they go to <overflow_> as one
+// batch first.
 template <typename T> void
 LQueue_Node<T>::operator delete (void *ptr)
 {
 	if (ptr != nullptr) {
 		LQueue_Node<T>* tempNode = static_cast<LQueue_Node<T>*>(ptr);
-		tempNode->next_ = free_list_;
-		free_list_ = tempNode;
+		Free_List &free_list = free_list_;
+		if (free_list.count_ >= FREE_LIST_BOUND) {
+			free_list.stats_.spills_ += free_list.count_;
+			overflow_push(free_list.head_, free_list.count_);
+			free_list.head_ = nullptr;
+			free_list.count_ = 0;
+		}
+		tempNode->next_ = free_list.head_;
+		free_list.head_ = tempNode;
+		++free_list.count_;
 	}
 }
 
-// Returns all dynamic memory on the free list to the free store.
+// Returns the calling thread's free list and the shared pool to the
+// free store.
 template <typename T> void
 LQueue_Node<T>::free_list_release(void)
 {
-	while (free_list_ != nullptr) {
-		LQueue_Node<T>* temp = free_list_;
-		free_list_ = free_list_->next_;
+	Free_List &free_list = free_list_;
+	Batch *batch = batch_of(overflow_.exchange(0, std::memory_order_acquire));
+	while (batch != nullptr) {
+		Batch *next = batch->next_;
+		LQueue_Node<T> *node = batch->nodes_;
+		::operator delete(batch);
+		while (node != nullptr) {
+			LQueue_Node<T>* temp = node;
+			node = node->next_;
+			::operator delete(temp);
+		}
+		batch = next;
+	}
+	while (free_list.head_ != nullptr) {
+		LQueue_Node<T>* temp = free_list.head_;
+		free_list.head_ = free_list.head_->next_;
 		::operator delete(temp);
 	}
+	free_list.count_ = 0;
 }
 
-// Preallocate <n> <LQueue_Nodes> and store them on the
-// <free_list_>
+// Make sure the calling thread's <free_list_> holds at least <n>
+// <LQueue_Nodes>, but never more than <FREE_LIST_BOUND>.
 template <typename T> void
 LQueue_Node<T>::free_list_allocate(size_t n)
 {
-	while (n > 0) {
-		--n;
+	Free_List &free_list = free_list_;
+	if (n > FREE_LIST_BOUND)
+		n = FREE_LIST_BOUND;
+	if (free_list.count_ == 0 && n > 0)
+		refill(free_list);
+	while (free_list.count_ < n) {
 		LQueue_Node<T> *tempNode = (LQueue_Node<T> *)::operator new(sizeof(LQueue_Node<T>));
-		tempNode->next_ = free_list_;
-		free_list_ = tempNode;
+		tempNode->next_ = free_list.head_;
+		free_list.head_ = tempNode;
+		++free_list.count_;
 	}
 }
 
+// Returns the counters of the calling thread added to those of all
+// threads that have already exited.
+template <typename T> Free_List_Stats
+LQueue_Node<T>::free_list_stats(void)
+{
+	const Free_List_Stats &stats = free_list_.stats_;
+	Free_List_Stats total;
+	total.hits_ = stats.hits_ + retired_stats_.hits_;
+	total.refills_ = stats.refills_ + retired_stats_.refills_;
+	total.misses_ = stats.misses_ + retired_stats_.misses_;
+	total.spills_ = stats.spills_ + retired_stats_.spills_;
+	return total;
+}
+
 template <typename T>
 LQueue_Node<T>::LQueue_Node(LQueue_Node<T> *next,LQueue_Node<T> *prev)
 	: next_(next),prev_(prev)
@@ -107,10 +251,12 @@ LQueue<T, LQUEUE_NODE>& LQueue<T, LQUEUE_NODE>::operator=(const LQueue<T, LQUEUE
 
 template <typename T, typename LQUEUE_NODE = LQueue_Node<T> >
 LQueue<T, LQUEUE_NODE>::~LQueue() {
-	LQUEUE_NODE::free_list_release();
+	// The nodes go back to this thread's free list for the next queue,
+	// the free lists themselves are released by the Options dtor.
 	while (count_ > 0) {
 		dequeue();
 	}
+	delete tail_; // the dummy node
 }
 // Place a <new_item> at the tail of the queue.  Throws the
 // <Overflow> exception if the queue is full, e.g., if memory is exhausted.
@@ -168,6 +314,39 @@ T LQueue<T, LQUEUE_NODE>::front(void) const {
 		throw(Underflow());
 }
 
+// Place the <n> items starting at <items> at the tail of the queue.
+template <typename T, typename LQUEUE_NODE>
+void LQueue<T, LQUEUE_NODE>::enqueue_n(const T *items, size_t n) {
+	for (size_t i = 0; i < n; ++i)
+		enqueue(items[i]);
+}
+
+// Remove up to <n> items from the front into <items>, unlinking the
+// nodes without the per item emptiness checks of <dequeue>.
+template <typename T, typename LQUEUE_NODE>
+size_t LQueue<T, LQUEUE_NODE>::dequeue_n(T *items, size_t n) {
+	size_t count = 0;
+	for (; count < n && count_ > 0; ++count) {
+		LQUEUE_NODE * head = tail_->next_;
+		items[count] = head->item_;
+
+		tail_->next_ = head->next_;
+		head->next_->prev_ = tail_;
+		--count_;
+		delete head;
+	}
+	return count;
+}
+
+// Remove all the items and append them to <items>.
+template <typename T, typename LQUEUE_NODE>
+size_t LQueue<T, LQUEUE_NODE>::drain(std::vector<T> &items) {
+	size_t count = count_;
+	size_t first = items.size();
+	items.resize(first + count);
+	return dequeue_n(items.data() + first, count);
+}
+
 // Efficiently swap the contents of this <LQueue> with <new_aqueue>.
 // Does not throw an exception.
 template<typename T, typename LQUEUE_NODE = LQueue_Node<T>>
@@ -1,7 +1,36 @@
 #pragma once
 #ifndef _LQUEUE_H
 #define _LQUEUE_H
+#include <atomic>
+#include <stdint.h>
 #include "Queue.h"
+
+// Counters describing how <LQueue_Node> allocations were served.
+struct Free_List_Stats
+{
+	size_t hits_;
+	// Allocations served from the calling thread's cache.
+
+	size_t refills_;
+	// Allocations that refilled the thread's cache from the shared pool.
+
+	size_t misses_;
+	// Allocations that went to the global <::operator new>.
+
+	size_t spills_;
+	// Nodes handed to the shared pool because a thread's cache was full,
+	// a batch of <FREE_LIST_BOUND> at a time.
+};
+
+// <Free_List_Stats> that threads can add to concurrently.
+struct Atomic_Free_List_Stats
+{
+	std::atomic<size_t> hits_;
+	std::atomic<size_t> refills_;
+	std::atomic<size_t> misses_;
+	std::atomic<size_t> spills_;
+};
+
 //Defines an element in the <LQueue>.
 template <typename T>
 class LQueue_Node
@@ -16,23 +45,103 @@ public:
 	~LQueue_Node(void);
 
 	void *operator new (size_t);
-	// Allocate a new <LQueue_Node>, trying first from the
-	// <free_list_> and if that's empty try from the global <::operator new>.
+	// Allocate a new <LQueue_Node>, trying first from the calling
+	// thread's <free_list_>, then from the shared <overflow_> pool and
+	// if both are empty from the global <::operator new>.  No locks
+	// are taken.
 
 	void operator delete (void *ptr);
-	// Return <ptr> to the <free_list_>.
+	// Return <ptr> to the calling thread's <free_list_>.  If that
+	// already holds <FREE_LIST_BOUND> nodes they go to the shared
+	// <overflow_> pool as one batch first.
 
 	static void free_list_allocate(size_t n);
-	// Preallocate <n> <LQueue_Nodes> and store them on the
-	// <free_list_>.
+	// Make sure the calling thread's <free_list_> holds at least <n>
+	// <LQueue_Nodes> (at most <FREE_LIST_BOUND>).
 
 	static void free_list_release(void);
-	// Returns all dynamic memory on the free list to the free store.
+	// Returns the calling thread's free list and the shared pool to
+	// the free store.  Free lists of other threads are not touched.
+
+	static Free_List_Stats free_list_stats(void);
+	// Returns the counters of the calling thread added to those of
+	// all threads that have already exited.
+
+	static const size_t FREE_LIST_BOUND = 256;
+	// Maximum number of nodes cached per thread.
+
+	/**
+	* @class Free_List
+	* @brief Per thread stack of unused <LQueue_Nodes>.  Its nodes go
+	* to the shared pool as one batch when the thread exits.
+	*/
+	class Free_List
+	{
+	public:
+		Free_List(void);
+		~Free_List(void);
+
+		LQueue_Node<T> *head_;
+		// Top of the stack, linked through <next_>.
+
+		size_t count_;
+		// Number of nodes on the stack.
+
+		Free_List_Stats stats_;
+		// Counters for this thread.
+	};
+
+	static thread_local Free_List free_list_;
+	// The calling thread's cache, used without synchronization.
+
+	static std::atomic<uint64_t> overflow_;
+	// Lock-free stack of batches shared by all threads, see <Batch>.
+	// A batch is pushed and popped whole with one compare-and-swap of
+	// the top.  The top is tagged with a count of its changes, so a pop
+	// that read a batch that has since been popped and pushed again
+	// fails instead of linking in a stale <next_> (the ABA problem).
+
+	static Atomic_Free_List_Stats retired_stats_;
+	// Counters of the threads that have exited.
 
-	static LQueue_Node<T> *free_list_;
-	// Head of the "free list", which is a stack of
-	// <LQueue_Nodes> used to speed up allocation.
+private:
+	/**
+	* @class Batch
+	* @brief Up to <FREE_LIST_BOUND> unused nodes on <overflow_>, kept
+	* in the memory of the first of them.  The others are linked from
+	* <nodes_> through <next_>, so the batch is taken over whole without
+	* walking it.
+	*/
+	struct Batch
+	{
+		Batch *next_;
+		// Next batch on <overflow_>.
+
+		LQueue_Node<T> *nodes_;
+		// The nodes after the first.
+
+		size_t count_;
+		// Number of nodes, the first included.
+	};
+
+	static void overflow_push(LQueue_Node<T> *head, size_t count);
+	// Push the <count> nodes linked from <head> onto <overflow_> as
+	// one batch.
+
+	static void refill(Free_List &free_list);
+	// Move the top batch of <overflow_> to the empty <free_list>.
+
+	static const unsigned TAG_SHIFT = sizeof(void *) == 8 ? 48 : 32;
+	// The bits of the top of <overflow_> above an address, which hold
+	// its tag.
+
+	static uint64_t tagged(Batch *batch, uint64_t tag);
+	// Returns the top of <overflow_> for <batch> with <tag>.
+
+	static Batch *batch_of(uint64_t top);
+	// Returns the batch of the top of <overflow_>.
 
+public:
 	T item_;
 	// Item in this node.
 
@@ -104,6 +213,18 @@ public:
 	// Throws the <Underflow> exception if the queue is empty. 
 	T front(void) const;
 
+	// Place the <n> items starting at <items> at the tail of the queue.
+	// Throws the <Overflow> exception if memory is exhausted.
+	void enqueue_n(const T *items, size_t n);
+
+	// Remove up to <n> items from the front into <items>.  Returns the
+	// number removed.
+	size_t dequeue_n(T *items, size_t n);
+
+	// Remove all the items and append them to <items>.  Returns the
+	// number removed.
+	size_t drain(std::vector<T> &items);
+
 	// = Check boundary conditions for Queue operations. 
 
 	// Returns 1 if the queue is empty, otherwise returns 0. 
@@ -0,0 +1,266 @@
+#include "stdafx.h"
+#if !defined (_Latency_Histogram_CPP)
+#define _Latency_Histogram_CPP
+
+#include <chrono>
+#include <csignal>
+#include <cmath>
+#include "Latency_Histogram.h"
+
+#if defined (_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace
+{
+	/// Names of the phases in <Latency_Phase> order.
+	const char *phase_names[LATENCY_PHASE_COUNT] = {
+		"parse",
+		"build",
+		"evaluate"
+	};
+
+	/// Signal that asks for the percentiles.
+#if defined (SIGUSR1)
+	const int REPORT_SIGNAL = SIGUSR1;
+#else
+	const int REPORT_SIGNAL = SIGBREAK;
+#endif
+
+	/// Returns the position of the highest set bit of <value>, not 0.
+	size_t highest_bit(uint64_t value)
+	{
+#if defined (_MSC_VER)
+		unsigned long bit;
+		_BitScanReverse64(&bit, value);
+		return bit;
+#else
+		return 63 - __builtin_clzll(value);
+#endif
+	}
+}
+
+// Ctor
+Latency_Histogram::Latency_Histogram(void)
+	:max_{ 0 }
+{
+	for (size_t i = 0; i < BUCKET_COUNT; ++i)
+		counts_[i].store(0, std::memory_order_relaxed);
+}
+
+// Add the counts of <other>.
+void
+Latency_Histogram::merge(const Latency_Histogram &other)
+{
+	for (size_t i = 0; i < BUCKET_COUNT; ++i) {
+		const uint64_t count = other.counts_[i].load(std::memory_order_relaxed);
+		if (count != 0)
+			counts_[i].store(counts_[i].load(std::memory_order_relaxed) + count,
+				std::memory_order_relaxed);
+	}
+
+	const uint64_t other_max = other.max_.load(std::memory_order_relaxed);
+	if (other_max > max_.load(std::memory_order_relaxed))
+		max_.store(other_max, std::memory_order_relaxed);
+}
+
+// Returns the number of latencies counted.
+uint64_t
+Latency_Histogram::count(void) const
+{
+	uint64_t total = 0;
+	for (size_t i = 0; i < BUCKET_COUNT; ++i)
+		total += counts_[i].load(std::memory_order_relaxed);
+	return total;
+}
+
+// Returns the largest latency counted.
+uint64_t
+Latency_Histogram::max(void) const
+{
+	return max_.load(std::memory_order_relaxed);
+}
+
+// Returns the highest value of the bucket holding the latency ranked
+// <percentile> percent of the way through the counted ones, but never
+// more than the maximum.
+uint64_t
+Latency_Histogram::percentile(double percentile) const
+{
+	const uint64_t total = count();
+	if (total == 0)
+		return 0;
+
+	uint64_t rank = static_cast<uint64_t>(std::ceil(percentile / 100 * total));
+	if (rank == 0)
+		rank = 1;
+
+	uint64_t seen = 0;
+	for (size_t i = 0; i < BUCKET_COUNT; ++i) {
+		seen += counts_[i].load(std::memory_order_relaxed);
+		if (seen >= rank) {
+			const uint64_t highest = highest_value_of(i);
+			return highest < max() ? highest : max();
+		}
+	}
+	return max();
+}
+
+// Print the count and the percentiles in nanoseconds.
+void
+Latency_Histogram::print(std::ostream &output, const std::string &name) const
+{
+	output << name << "," << count()
+		<< "," << percentile(50)
+		<< "," << percentile(90)
+		<< "," << percentile(99)
+		<< "," << percentile(99.9)
+		<< "," << max() << std::endl;
+}
+
+// Values below 2^SUB_BUCKET_BITS are their own bucket.  Above that a
+// value is shifted right until it has SUB_BUCKET_BITS bits, and the
+// shift picks the power of two, the remaining low bits the bucket in
+// it.
+size_t
+Latency_Histogram::index_of(uint64_t value)
+{
+	const uint64_t sub_buckets = 1 << SUB_BUCKET_BITS;
+	const uint64_t half = sub_buckets / 2;
+	if (value < sub_buckets)
+		return static_cast<size_t>(value);
+
+	const size_t shift = highest_bit(value) - SUB_BUCKET_BITS + 1;
+	return static_cast<size_t>(sub_buckets + (shift - 1) * half + (value >> shift) - half);
+}
+
+// Inverse of index_of, to the top of the bucket.
+uint64_t
+Latency_Histogram::highest_value_of(size_t index)
+{
+	const uint64_t sub_buckets = 1 << SUB_BUCKET_BITS;
+	const uint64_t half = sub_buckets / 2;
+	if (index < sub_buckets)
+		return index;
+
+	const uint64_t shift = (index - sub_buckets) / half + 1;
+	const uint64_t lowest = ((index - sub_buckets) % half + half) << shift;
+	return lowest + ((uint64_t(1) << shift) - 1);
+}
+
+// The histograms of one thread.
+struct Latency_Histograms::Thread_Histograms
+{
+	Thread_Histograms(void)
+		:next_{ nullptr }
+	{}
+
+	Latency_Histogram phases_[LATENCY_PHASE_COUNT];
+	// One histogram per <Latency_Phase>.
+
+	Thread_Histograms *next_;
+	// Next thread's histograms, set before they are pushed.
+};
+
+/* statics of the histograms */
+std::atomic<bool> Latency_Histograms::enabled_{ false };
+std::atomic<Latency_Histograms::Thread_Histograms *> Latency_Histograms::threads_{ nullptr };
+std::atomic<bool> Latency_Histograms::signalled_{ false };
+
+// Returns the calling thread's histograms.
+Latency_Histograms::Thread_Histograms &
+Latency_Histograms::histograms(void)
+{
+	static thread_local Thread_Histograms *histograms = nullptr;
+	if (histograms == nullptr) {
+		histograms = new Thread_Histograms;
+		histograms->next_ = threads_.load(std::memory_order_relaxed);
+		while (!threads_.compare_exchange_weak(histograms->next_, histograms,
+			std::memory_order_release, std::memory_order_relaxed))
+			;
+	}
+	return *histograms;
+}
+
+// Start or stop recording.
+void
+Latency_Histograms::enable(bool on)
+{
+	enabled_.store(on, std::memory_order_relaxed);
+}
+
+// Count one latency for the calling thread.
+void
+Latency_Histograms::record(Latency_Phase phase, uint64_t nanoseconds)
+{
+	histograms().phases_[phase].record(nanoseconds);
+}
+
+// Add every thread's latencies of <phase> to <histogram>.
+void
+Latency_Histograms::merge_into(Latency_Phase phase, Latency_Histogram &histogram)
+{
+	for (Thread_Histograms *thread = threads_.load(std::memory_order_acquire);
+		thread != nullptr; thread = thread->next_)
+		histogram.merge(thread->phases_[phase]);
+}
+
+// Returns the name <phase> is printed under.
+const char *
+Latency_Histograms::name(Latency_Phase phase)
+{
+	return phase_names[phase];
+}
+
+// Returns a steady time in nanoseconds, never 0.
+uint64_t
+Latency_Histograms::now(void)
+{
+	return 1 + std::chrono::duration_cast<std::chrono::nanoseconds>(
+		std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// Print the merged percentiles of each phase.
+void
+Latency_Histograms::print(std::ostream &output)
+{
+	output << "latency_ns,count,p50,p90,p99,p99.9,max" << std::endl;
+	for (size_t i = 0; i < LATENCY_PHASE_COUNT; ++i) {
+		const Latency_Phase phase = static_cast<Latency_Phase>(i);
+		Latency_Histogram merged;
+		merge_into(phase, merged);
+		merged.print(output, phase_names[i]);
+	}
+}
+
+// Print to std::cout.
+void
+Latency_Histograms::print_at_exit(void)
+{
+	print(std::cout);
+}
+
+// Install the handler of the report signal.
+void
+Latency_Histograms::print_on_signal(void)
+{
+	std::signal(REPORT_SIGNAL, &Latency_Histograms::on_signal);
+}
+
+// Print if the report signal arrived.
+void
+Latency_Histograms::poll(std::ostream &output)
+{
+	if (signalled_.load(std::memory_order_relaxed) && signalled_.exchange(false))
+		print(output);
+}
+
+// Only note the signal, poll does the printing.
+void
+Latency_Histograms::on_signal(int)
+{
+	signalled_.store(true, std::memory_order_relaxed);
+	std::signal(REPORT_SIGNAL, &Latency_Histograms::on_signal);
+}
+
+#endif /* _Latency_Histogram_CPP */
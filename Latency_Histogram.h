@@ -0,0 +1,192 @@
+#pragma once
+#ifndef _Latency_Histogram_H
+#define _Latency_Histogram_H
+
+// This header defines "size_t"
+#include <stdlib.h>
+#include <stdint.h>
+#include <string>
+#include <iostream>
+#include <atomic>
+
+/**
+* @class Latency_Histogram
+* @brief Counts of latencies in nanoseconds in log linear buckets, the
+*        way an HDR histogram keeps them: below 2^SUB_BUCKET_BITS every
+*        value has its own bucket, above it every power of two is split
+*        into 2^(SUB_BUCKET_BITS - 1) buckets.  Any value up to 2^64 is
+*        kept with a relative error under 2^-(SUB_BUCKET_BITS - 1), in
+*        a fixed array.
+*
+*        One thread records, any thread may read or merge at the same
+*        time.  The counts are relaxed atomics, so a reader sees each
+*        count whole but not necessarily the latest ones.
+*/
+class Latency_Histogram
+{
+public:
+	/// Bits of precision kept of each value.
+	static const size_t SUB_BUCKET_BITS = 7;
+
+	/// Number of buckets.
+	static const size_t BUCKET_COUNT =
+		(1 << SUB_BUCKET_BITS) + (64 - SUB_BUCKET_BITS) * (1 << (SUB_BUCKET_BITS - 1));
+
+	/// Ctor - empty.
+	Latency_Histogram(void);
+
+	/// Count one latency of <nanoseconds>.  Only one thread may record.
+	void record(uint64_t nanoseconds) {
+		std::atomic<uint64_t> &count = counts_[index_of(nanoseconds)];
+		count.store(count.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+		if (nanoseconds > max_.load(std::memory_order_relaxed))
+			max_.store(nanoseconds, std::memory_order_relaxed);
+	}
+
+	/// Add the counts of <other> to this histogram.  Only the thread
+	/// that records into this one may merge into it.
+	void merge(const Latency_Histogram &other);
+
+	/// Returns the number of latencies counted.
+	uint64_t count(void) const;
+
+	/// Returns the largest latency counted, exactly.
+	uint64_t max(void) const;
+
+	/// Returns the latency <percentile> percent of the counted ones are
+	/// at or below, as the largest value of its bucket.
+	uint64_t percentile(double percentile) const;
+
+	/// Print "name,count,p50,p90,p99,p99.9,max".
+	void print(std::ostream &output, const std::string &name) const;
+
+private:
+	// Copying is not supported.
+	Latency_Histogram(const Latency_Histogram &);
+	void operator= (const Latency_Histogram &);
+
+	/// Returns the bucket <value> is counted in.
+	static size_t index_of(uint64_t value);
+
+	/// Returns the largest value counted in bucket <index>.
+	static uint64_t highest_value_of(size_t index);
+
+	std::atomic<uint64_t> counts_[BUCKET_COUNT];
+	// Number of latencies in each bucket.
+
+	std::atomic<uint64_t> max_;
+	// Largest latency counted.
+};
+
+/// Phases of an expression whose latencies are kept.
+enum Latency_Phase
+{
+	PARSE_LATENCY,
+	// Interpreter::parse.
+
+	BUILD_LATENCY,
+	// Interpreter::build.
+
+	EVALUATE_LATENCY,
+	// Evaluating the tree and writing the result.
+
+	LATENCY_PHASE_COUNT
+};
+
+/**
+* @class Latency_Histograms
+* @brief A Latency_Histogram per <Latency_Phase> for every thread that
+*        records, merged when printed.
+*
+*        A thread's histograms are made the first time it records and
+*        pushed on a list with a compare and swap.  They are never
+*        freed, so the latencies of threads that have exited are still
+*        printed, and neither recording nor merging takes a lock.
+*        Nothing is recorded until the histograms are enabled.
+*/
+class Latency_Histograms
+{
+public:
+	/// Start or stop recording.
+	static void enable(bool on);
+
+	/// Returns true while recording.
+	static bool is_enabled(void) {
+		return enabled_.load(std::memory_order_relaxed);
+	}
+
+	/// Count one latency of <nanoseconds> in <phase> for the calling
+	/// thread.
+	static void record(Latency_Phase phase, uint64_t nanoseconds);
+
+	/// Add the latencies of <phase> of every thread to <histogram>.
+	static void merge_into(Latency_Phase phase, Latency_Histogram &histogram);
+
+	/// Returns the name <phase> is printed under.
+	static const char *name(Latency_Phase phase);
+
+	/// Returns a steady time in nanoseconds.
+	static uint64_t now(void);
+
+	/// Print the merged percentiles of each phase, one line each.
+	static void print(std::ostream &output);
+
+	/// Print to std::cout, for use with atexit.
+	static void print_at_exit(void);
+
+	/// Print to std::cout at the next <poll> after the report signal,
+	/// SIGUSR1 or, where there is none, SIGBREAK.
+	static void print_on_signal(void);
+
+	/// Print to <output> if the report signal arrived since the last
+	/// poll.  Call it where printing is safe, a signal handler cannot.
+	static void poll(std::ostream &output);
+
+private:
+	/// The histograms of one thread.
+	struct Thread_Histograms;
+
+	static Thread_Histograms &histograms(void);
+	// Returns the calling thread's histograms, making them first.
+
+	static void on_signal(int signal);
+	// Handler of the report signal.
+
+	static std::atomic<bool> enabled_;
+	// True while recording.
+
+	static std::atomic<Thread_Histograms *> threads_;
+	// Every thread's histograms, newest first.
+
+	static std::atomic<bool> signalled_;
+	// Set by the report signal, cleared by poll.
+};
+
+/**
+* @class Latency_Span
+* @brief Records the time from its construction to its destruction as
+*        a latency of <phase> on the calling thread.
+*/
+class Latency_Span
+{
+public:
+	/// Ctor
+	Latency_Span(Latency_Phase phase)
+		:phase_{ phase }, start_{ Latency_Histograms::is_enabled() ? Latency_Histograms::now() : 0 }
+	{}
+
+	/// Dtor
+	~Latency_Span(void) {
+		if (start_ != 0)
+			Latency_Histograms::record(phase_, Latency_Histograms::now() - start_);
+	}
+
+private:
+	/// Phase the latency is counted in.
+	Latency_Phase phase_;
+
+	/// Start time, 0 if recording was off.
+	uint64_t start_;
+};
+
+#endif /* _Latency_Histogram_H */
@@ -8,14 +8,19 @@
 /**
 * @class Leaf_Node
 * @brief Defines the leaf node of Composite Hierarchy.
+*
+*        A leaf built for a variable also keeps the variable's id, see
+*        Interpreter_Context::variable_id, so a query can tell it from a
+*        number that has the same value.
 */
 template <typename T>
 class Leaf_Node : public Component_Node<T>
 {
 public:
-	/// Ctor
-	Leaf_Node(const T &item)
-		:item_{item}
+	/// Ctor - <variable> is the id of the variable <item> is the value
+	/// of, 0 for a number.
+	Leaf_Node(const T &item, int variable = 0)
+		:item_{item}, variable_{ variable }
 	{
 		//std::cout << "Dtor for:" << item_ << std::endl;
 	}
@@ -26,6 +31,7 @@ public:
 
 	/// Accept method for visitor
 	virtual void accept(Visitor& v) {
+		HOT_COUNT(VISITOR_VISITS);
 		v.visit(*this);
 	}
 
@@ -34,10 +40,30 @@ public:
 		return item_;
 	}
 
+	/// Return the id of the variable the item is the value of, 0 if
+	/// the leaf is a number.
+	int variable(void) const {
+		return variable_;
+	}
+
+	/// Return the number of bytes relocate needs.
+	virtual size_t node_size(void) const {
+		return sizeof(Leaf_Node<T>);
+	}
+
+	/// Build a copy of this leaf at <where>.
+	virtual Component_Node<T> *relocate(void *where,
+		const Node_Child<T> &, const Node_Child<T> &) const {
+		return new (where) Leaf_Node<T>(item_, variable_);
+	}
+
 protected:
 
 	/// Item stored in the node.
 	T item_;
+
+	/// Id of the variable <item_> is the value of, 0 for a number.
+	int variable_;
 };
 
 #endif /* _Leaf_Node_H */
\ No newline at end of file
@@ -0,0 +1,189 @@
+#pragma once
+#ifndef _Level_Frontier_H
+#define _Level_Frontier_H
+
+// This header defines "size_t"
+#include <stdlib.h>
+#include <vector>
+#include <thread>
+#include <atomic>
+
+#include "Tree.h"
+#include "Component_Node.h"
+
+/**
+* @class Level_Frontier
+* @brief Breadth first traversal one whole level at a time.  The nodes
+*        of the current level are kept left to right in one array, and
+*        expand builds the next level's array from it, splitting wide
+*        levels between threads:
+*
+*        for (Level_Frontier<int> level(tree); !level.empty(); level.expand())
+*            on_level(level.level(), level.nodes(), level.size());
+*
+*        Each thread takes a contiguous slice of the level, counts the
+*        children in it, and once every thread has counted, writes them
+*        from the offset the earlier slices leave, so the next level is
+*        in order without a queue or a lock.  Levels of fewer than
+*        <MIN_NODES_PER_THREAD> nodes per thread are expanded on the
+*        calling thread alone, so a deep and narrow tree costs no more
+*        than a queue based traversal.
+*
+*        The nodes are only read.  The frontier keeps the tree alive;
+*        the callbacks must not copy Tree handles to the nodes on the
+*        worker threads.
+*/
+template <typename T>
+class Level_Frontier
+{
+public:
+	/// Fewest nodes of a level each thread expanding it takes.
+	static const size_t MIN_NODES_PER_THREAD = 4096;
+
+	/// Ctor - the root's level of <tree>, expanded on <threads> threads,
+	/// or as many as the hardware runs at once if 0.
+	explicit Level_Frontier(const Tree<T> &tree, size_t threads = 0)
+		:tree_{ tree }, level_{ 0 }, size_{ 0 }, threads_{ threads }
+	{
+		if (threads_ == 0)
+			threads_ = std::thread::hardware_concurrency();
+		if (threads_ == 0)
+			threads_ = 1;
+
+		// The widest level of a tree with Tree_Stats is known up front.
+		if (tree.has_stats()) {
+			nodes_.reserve(tree.stats().max_width_);
+			next_.reserve(tree.stats().max_width_);
+		}
+		if (!tree.is_null()) {
+			nodes_.push_back(tree.get_root());
+			size_ = 1;
+		}
+	}
+
+	/// Returns true once past the last level.
+	bool empty(void) const {
+		return size_ == 0;
+	}
+
+	/// Returns the number of the current level, the root's is 0.
+	size_t level(void) const {
+		return level_;
+	}
+
+	/// Returns the nodes of the current level, left to right.
+	Component_Node<T> *const *nodes(void) const {
+		return nodes_.data();
+	}
+
+	/// Returns the number of nodes in the current level.
+	size_t size(void) const {
+		return size_;
+	}
+
+	/// Move to the next level.
+	void expand(void) {
+		expand([](Component_Node<T> *, size_t) {});
+	}
+
+	/// Move to the next level, calling <on_node>(node, worker) for
+	/// every node of the current level on the thread that expands it.
+	/// <worker> numbers the threads from 0, the calling thread, so
+	/// <on_node> can keep what it finds per thread.  It must not throw.
+	template <typename FUNCTION>
+	void expand(FUNCTION on_node) {
+		if (size_ == 0)
+			return;
+		if (next_.size() < 2 * size_)
+			next_.resize(2 * size_);
+
+		size_t workers = size_ / MIN_NODES_PER_THREAD;
+		if (workers > threads_)
+			workers = threads_;
+		if (workers == 0)
+			workers = 1;
+
+		std::vector<size_t> counts(workers);
+		std::atomic<size_t> counted{ 0 };
+		auto work = [&](size_t worker) {
+			const size_t begin = size_ * worker / workers;
+			const size_t end = size_ * (worker + 1) / workers;
+
+			size_t children = 0;
+			for (size_t i = begin; i < end; ++i) {
+				Component_Node<T> *node = nodes_[i];
+				on_node(node, worker);
+				children += (node->left() != nullptr) + (node->right() != nullptr);
+			}
+			counts[worker] = children;
+
+			// Wait for the earlier slices' counts to know where this
+			// slice's children go.
+			counted.fetch_add(1, std::memory_order_release);
+			while (counted.load(std::memory_order_acquire) < workers)
+				std::this_thread::yield();
+
+			size_t offset = 0;
+			for (size_t w = 0; w < worker; ++w)
+				offset += counts[w];
+			for (size_t i = begin; i < end; ++i) {
+				Component_Node<T> *node = nodes_[i];
+				if (node->left() != nullptr)
+					next_[offset++] = node->left();
+				if (node->right() != nullptr)
+					next_[offset++] = node->right();
+			}
+		};
+
+		std::vector<std::thread> threads;
+		for (size_t worker = 1; worker < workers; ++worker)
+			threads.push_back(std::thread(work, worker));
+		work(0);
+		for (size_t i = 0; i < threads.size(); ++i)
+			threads[i].join();
+
+		size_t next_size = 0;
+		for (size_t w = 0; w < workers; ++w)
+			next_size += counts[w];
+		nodes_.swap(next_);
+		size_ = next_size;
+		++level_;
+	}
+
+private:
+	// Copying is not supported.
+	Level_Frontier(const Level_Frontier &);
+	void operator= (const Level_Frontier &);
+
+	/// Keeps the nodes alive.
+	Tree<T> tree_;
+
+	/// The current level in its first <size_> elements.
+	std::vector<Component_Node<T> *> nodes_;
+
+	/// Where the next level is built, kept to reuse its memory.
+	std::vector<Component_Node<T> *> next_;
+
+	/// Number of the current level.
+	size_t level_;
+
+	/// Number of nodes in the current level.
+	size_t size_;
+
+	/// Most threads expanding a level.
+	size_t threads_;
+};
+
+/// Walk <tree> a level at a time with a Level_Frontier on <threads>
+/// threads: <on_level>(level, nodes, count) is called on the calling
+/// thread with each level before it is expanded, and <on_node>(node,
+/// worker) on the thread that expands it with each node.
+template <typename T, typename LEVEL_FUNCTION, typename NODE_FUNCTION>
+void parallel_level_order(const Tree<T> &tree, LEVEL_FUNCTION on_level,
+	NODE_FUNCTION on_node, size_t threads = 0)
+{
+	for (Level_Frontier<T> frontier(tree, threads); !frontier.empty(); frontier.expand(on_node))
+		on_level(frontier.level(), frontier.nodes(), frontier.size());
+}
+
+#endif /* _Level_Frontier_H */
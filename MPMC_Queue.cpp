@@ -0,0 +1,195 @@
+#include "stdafx.h"
+#if !defined (_MPMC_QUEUE_CPP)
+#define _MPMC_QUEUE_CPP
+
+#include <stddef.h>
+#include <utility>
+#include "MPMC_Queue.h"
+
+// Constructor.
+template <typename T>
+MPMC_Queue<T>::MPMC_Queue(size_t size)
+	:slots_{ nullptr }, mask_{ 0 }, enqueue_pos_{ 0 }, dequeue_pos_{ 0 }
+{
+	size_t capacity = 2;
+	while (capacity < size)
+		capacity <<= 1;
+
+	slots_ = new Slot[capacity];
+	mask_ = capacity - 1;
+
+	// Slot i is free for the producer that claims position i.
+	for (size_t i = 0; i < capacity; ++i)
+		slots_[i].sequence_.store(i, std::memory_order_relaxed);
+}
+
+// Copy constructor.
+template <typename T>
+MPMC_Queue<T>::MPMC_Queue(const MPMC_Queue<T> &rhs)
+	:slots_{ new Slot[rhs.mask_ + 1] }, mask_{ rhs.mask_ },
+	enqueue_pos_{ rhs.enqueue_pos_.load() }, dequeue_pos_{ rhs.dequeue_pos_.load() }
+{
+	for (size_t i = 0; i <= mask_; ++i) {
+		slots_[i].sequence_.store(rhs.slots_[i].sequence_.load(), std::memory_order_relaxed);
+		slots_[i].item_ = rhs.slots_[i].item_;
+	}
+}
+
+// Dtor.
+template <typename T>
+MPMC_Queue<T>::~MPMC_Queue(void)
+{
+	delete[] slots_;
+}
+
+// Copy <new_item> to the tail of the queue.
+template <typename T>
+bool MPMC_Queue<T>::try_push(const T &new_item)
+{
+	T item(new_item);
+	return try_push(std::move(item));
+}
+
+// Move <new_item> to the tail of the queue.
+template <typename T>
+bool MPMC_Queue<T>::try_push(T &&new_item)
+{
+	Slot *slot;
+	size_t pos = enqueue_pos_.load(std::memory_order_relaxed);
+	for (;;) {
+		slot = &slots_[pos & mask_];
+		size_t sequence = slot->sequence_.load(std::memory_order_acquire);
+		ptrdiff_t difference = (ptrdiff_t)sequence - (ptrdiff_t)pos;
+
+		if (difference == 0) {
+			// The slot is free for this lap, try to claim the position.
+			if (enqueue_pos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+				break;
+		}
+		else if (difference < 0)
+			// The consumer of the previous lap has not emptied it: full.
+			return false;
+		else
+			// Another producer claimed this position first.
+			pos = enqueue_pos_.load(std::memory_order_relaxed);
+	}
+
+	slot->item_ = std::move(new_item);
+	slot->sequence_.store(pos + 1, std::memory_order_release);
+	HOT_COUNT(QUEUE_ENQUEUES);
+	return true;
+}
+
+// Move the front item into <item> and remove it.
+template <typename T>
+bool MPMC_Queue<T>::try_pop(T &item)
+{
+	Slot *slot;
+	size_t pos = dequeue_pos_.load(std::memory_order_relaxed);
+	for (;;) {
+		slot = &slots_[pos & mask_];
+		size_t sequence = slot->sequence_.load(std::memory_order_acquire);
+		ptrdiff_t difference = (ptrdiff_t)sequence - (ptrdiff_t)(pos + 1);
+
+		if (difference == 0) {
+			// The slot has been filled, try to claim the position.
+			if (dequeue_pos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+				break;
+		}
+		else if (difference < 0)
+			// The producer has not filled it yet: empty.
+			return false;
+		else
+			// Another consumer claimed this position first.
+			pos = dequeue_pos_.load(std::memory_order_relaxed);
+	}
+
+	item = std::move(slot->item_);
+	// Free the slot for the producer of the next lap.
+	slot->sequence_.store(pos + mask_ + 1, std::memory_order_release);
+	HOT_COUNT(QUEUE_DEQUEUES);
+	return true;
+}
+
+// Place a <new_item> at the tail of the queue.  Throws the
+// <Overflow> exception if the queue is full.
+template <typename T>
+void MPMC_Queue<T>::enqueue(const T &new_item)
+{
+	if (!try_push(new_item))
+		throw typename Queue<T>::Overflow();
+}
+
+// Remove the front item on the queue.  Throws the <Underflow>
+// exception if the queue is empty.
+template <typename T>
+void MPMC_Queue<T>::dequeue(void)
+{
+	T item;
+	if (!try_pop(item))
+		throw typename Queue<T>::Underflow();
+}
+
+// Place the <n> items starting at <items> at the tail of the queue.
+template <typename T>
+void MPMC_Queue<T>::enqueue_n(const T *items, size_t n)
+{
+	for (size_t i = 0; i < n; ++i)
+		if (!try_push(items[i]))
+			throw typename Queue<T>::Overflow();
+}
+
+// Remove up to <n> items with <try_pop>.
+template <typename T>
+size_t MPMC_Queue<T>::dequeue_n(T *items, size_t n)
+{
+	size_t count = 0;
+	while (count < n && try_pop(items[count]))
+		++count;
+	return count;
+}
+
+// Returns the front queue item without removing it.
+// Throws the <Underflow> exception if the queue is empty.
+template <typename T>
+T MPMC_Queue<T>::front(void) const
+{
+	size_t pos = dequeue_pos_.load(std::memory_order_relaxed);
+	const Slot &slot = slots_[pos & mask_];
+	if (slot.sequence_.load(std::memory_order_acquire) != pos + 1)
+		throw typename Queue<T>::Underflow();
+	return slot.item_;
+}
+
+// Returns 1 if the queue is empty, otherwise returns 0.
+template <typename T>
+bool MPMC_Queue<T>::is_empty(void) const
+{
+	return size() == 0;
+}
+
+// Returns 1 if the queue is full, otherwise returns 0.
+template <typename T>
+bool MPMC_Queue<T>::is_full(void) const
+{
+	return size() > mask_;
+}
+
+// Returns the current number of elements in the queue.  The dequeue
+// position is read first so the difference cannot go negative.
+template <typename T>
+size_t MPMC_Queue<T>::size(void) const
+{
+	size_t dequeue_pos = dequeue_pos_.load(std::memory_order_acquire);
+	size_t enqueue_pos = enqueue_pos_.load(std::memory_order_acquire);
+	return enqueue_pos - dequeue_pos;
+}
+
+// Clone the Queue.
+template <typename T>
+MPMC_Queue<T> *MPMC_Queue<T>::clone(void)
+{
+	return new MPMC_Queue<T>(*this);
+}
+
+#endif /* _MPMC_QUEUE_CPP */
@@ -0,0 +1,135 @@
+#pragma once
+#if !defined (_MPMC_QUEUE_H)
+#define _MPMC_QUEUE_H
+
+// This header defines "size_t"
+#include <stdlib.h>
+
+#include <atomic>
+
+#include "Hot_Counters.h"
+#include "Queue.h"
+
+/**
+* @class MPMC_Queue
+* @brief Defines a bounded lock-free queue that any number of threads
+* can enqueue to and dequeue from concurrently.
+*
+* The items live in a ring of <Slots> whose size is a power of two.
+* Each slot carries a sequence number that tells producers whether
+* the slot is free for the current lap of the ring and consumers
+* whether it has been filled, so claiming a position is a single
+* compare-and-swap on <enqueue_pos_> or <dequeue_pos_> and no thread
+* ever waits for another one to finish.
+*
+* Use <try_pop> rather than <front> followed by <dequeue> when more
+* than one thread consumes: only <try_pop> reads and removes the front
+* item atomically.
+*
+* Reference counts of a <Tree> are not atomic.  To hand a tree to
+* another thread, move the only handle to it into the queue with
+* <try_push(T &&)> and take it out with <try_pop>; neither touches
+* the count.
+*/
+template <typename T>
+class MPMC_Queue : public Queue<T>
+{
+public:
+	// Constructor.  <size> is rounded up to a power of two.
+	MPMC_Queue(size_t size);
+
+	// Copy constructor.  Must not run concurrently with other
+	// operations on <rhs>.
+	MPMC_Queue(const MPMC_Queue<T> &rhs);
+
+	// Dtor.
+	virtual ~MPMC_Queue(void);
+
+	// = Lock-free operations.
+
+	// Copy <new_item> to the tail of the queue.  Returns false if the
+	// queue is full.
+	bool try_push(const T &new_item);
+
+	// Move <new_item> to the tail of the queue.  Returns false, leaving
+	// <new_item> untouched, if the queue is full.
+	bool try_push(T &&new_item);
+
+	// Move the front item into <item> and remove it.  Returns false if
+	// the queue is empty.
+	bool try_pop(T &item);
+
+	// = Queue operations.
+
+	// Place a <new_item> at the tail of the queue.  Throws the
+	// <Overflow> exception if the queue is full.
+	virtual void enqueue(const T &new_item);
+
+	// Remove the front item on the queue.  Throws the <Underflow>
+	// exception if the queue is empty.
+	virtual void dequeue(void);
+
+	// Returns the front queue item without removing it.  Throws the
+	// <Underflow> exception if the queue is empty.  Only meaningful
+	// while no other thread is dequeueing.
+	virtual T front(void) const;
+
+	// Returns 1 if the queue is empty, otherwise returns 0.  With
+	// concurrent users this is a snapshot.
+	virtual bool is_empty(void) const;
+
+	// Returns 1 if the queue is full, otherwise returns 0.
+	virtual bool is_full(void) const;
+
+	// Returns the current number of elements in the queue.
+	virtual size_t size(void) const;
+
+	// Clone the Queue.  Must not run concurrently with other operations.
+	virtual MPMC_Queue<T> *clone(void);
+
+	// Place the <n> items starting at <items> at the tail of the queue.
+	// Throws the <Overflow> exception at the first item that does not
+	// fit.  Other producers may interleave their items.
+	virtual void enqueue_n(const T *items, size_t n);
+
+	// Remove up to <n> items with <try_pop>, so this is safe with
+	// concurrent consumers.  Returns the number removed.
+	virtual size_t dequeue_n(T *items, size_t n);
+
+private:
+	// Assignment is not supported.
+	void operator= (const MPMC_Queue<T> &);
+
+	// Position in the ring and the item stored there.
+	struct Slot
+	{
+		std::atomic<size_t> sequence_;
+		T item_;
+	};
+
+	// Size of the padding that keeps the producer and consumer
+	// positions on separate cache lines.
+	static const size_t CACHE_LINE = 64;
+
+	Slot *slots_;
+	// The ring of slots.
+
+	size_t mask_;
+	// Number of slots - 1.
+
+	char pad0_[CACHE_LINE];
+
+	std::atomic<size_t> enqueue_pos_;
+	// Next position producers will claim.
+
+	char pad1_[CACHE_LINE];
+
+	std::atomic<size_t> dequeue_pos_;
+	// Next position consumers will claim.
+
+	char pad2_[CACHE_LINE];
+};
+
+#include "MPMC_Queue.cpp"
+
+#endif /* _MPMC_QUEUE_H */
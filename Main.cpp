@@ -5,25 +5,20 @@
 #include <string>
 #include <vector>
 #include <functional>
+#include <cstdlib>
 
 #include "Tree.h"
 #include "Options.h"
 #include "Interpreter.h"
 #include "Eval_Visitor.h"
 #include "Print_Visitor.h"
-
-struct acceptor
-{
-	acceptor(Visitor &v) : visitor_(v) {}
-
-	void operator()(TREE t)
-	{
-		t.accept(visitor_);
-	}
-
-private:
-	Visitor &visitor_;
-};
+#include "Benchmark.h"
+#include "Pipeline.h"
+#include "Workload_Generator.h"
+#include "Hot_Counters.h"
+#include "Phase_Tracer.h"
+#include "Perf_Counters.h"
+#include "Latency_Histogram.h"
 
 int
 main(int argc, char *argv[])
@@ -38,6 +33,56 @@ main(int argc, char *argv[])
 		if (!Options::instance()->parse_args(argc, argv))
 			return 0;
 
+		// Print the hot path counters when the program ends, after the
+		// background reclaimer has stopped.
+		if (options->dump_counters())
+			std::atexit(&Hot_Counters::print_at_exit);
+
+		// Trace the processing phases, written out when the program ends.
+		if (!options->trace_file().empty()) {
+			Phase_Tracer::enable(true);
+			Phase_Tracer::write_at_exit(options->trace_file());
+		}
+
+		// Keep the latency of every expression, printed when the program
+		// ends or the report signal arrives.
+		if (options->latency_histograms()) {
+			Latency_Histograms::enable(true);
+			Latency_Histograms::print_on_signal();
+			std::atexit(&Latency_Histograms::print_at_exit);
+		}
+
+		// Keep tree teardown off this thread if asked to.
+		if (options->background_reclaim())
+			Node_Reclaimer<int>::instance()->background(true);
+
+		// Run the benchmarks instead of the interactive test if asked to.
+		if (options->benchmark_terms() > 0) {
+			Benchmark benchmark(options->benchmark_terms(),
+				options->benchmark_repetitions(), options->benchmark_warmup());
+			benchmark.run();
+			return 0;
+		}
+
+		// Print generated expressions if asked to, e.g. to feed -p.
+		if (!options->workload_spec().empty()) {
+			Workload_Generator generator(Workload_Generator::parse_spec(options->workload_spec()));
+			for (size_t i = 0; i < generator.spec().count_; ++i) {
+				generator.expression(std::cout);
+				std::cout << '\n';
+			}
+			std::cout.flush();
+			return 0;
+		}
+
+		// Evaluate a whole stream of expressions if asked to.
+		if (options->pipeline()) {
+			Pipeline pipeline;
+			pipeline.run(std::cin, std::cout);
+			pipeline.print_stats(std::cout);
+			return 0;
+		}
+
 		std::cout << "--Testing options class (singleton)--\n\n";
 
 		// Print out the options used.
@@ -49,36 +94,77 @@ main(int argc, char *argv[])
 		Interpreter_Context context;
 		Interpreter interpreter;
 
+		// Read the hardware counters around each phase if asked to.
+		const char *phases[] = { "interpret", "print_visitor", "eval_visitor" };
+		Perf_Sample samples[3];
+		std::unique_ptr<Perf_Counters> counters(
+			options->hardware_counters() ? new Perf_Counters : nullptr);
+
 		std::cout << "Please enter an expression..: " << std::endl;
 
 		std::string input;
 		std::getline(std::cin, input);
 
 		// Use the Interpreter to create the TREE.
-		TREE root_node = interpreter.interpret(context, input);
+		TREE root_node;
+		{
+			Perf_Span counted(counters.get(), samples[0]);
+			root_node = interpreter.interpret(context, input);
+		}
 
 		std::cout << "Testing the Eval_Visitor: " << std::endl;
 
-		Pre_Order_Eval_Visitor<int> eval_visitor;
+		Pre_Order_Eval_Visitor<int> eval_visitor(root_node);
 		Print_Visitor print_visitor;
 
-		std::vector<TREE> pre_order;
-
-		std::copy(root_node.begin("Preorder"),
-			root_node.end("Preorder"),
-			back_inserter(pre_order));
-
 		std::cout << std::endl << "contents of the tree in pre Order = " << std::endl;
 
-		std::for_each(pre_order.begin(),
-			pre_order.end(),
-			acceptor(print_visitor));
-
-		std::for_each(pre_order.rbegin(),
-			pre_order.rend(),
-			acceptor(eval_visitor));
-
-		std::cout << std::endl << "yield of the tree = " << eval_visitor.yield() << std::endl;
+		{
+			Trace_Span span("print_visitor");
+			Perf_Span counted(counters.get(), samples[1]);
+			for (Tree_Order_Iterator<int, Preorder> it = root_node.begin<Preorder>(),
+				end = root_node.end<Preorder>(); it != end; ++it)
+				it.get_node()->accept(print_visitor);
+		}
+
+		// A divisor that evaluates to 0, wherever it is in the tree,
+		// stops the evaluation with Division_By_Zero.
+		try {
+			// The reverse pre order is walked as it is needed, not copied,
+			// and the nodes are visited without making Tree handles.
+			{
+				Trace_Span span("eval_visitor");
+				Latency_Span latency(EVALUATE_LATENCY);
+				Perf_Span counted(counters.get(), samples[2]);
+				for (Tree_Order_Iterator<int, Reverse<Preorder> > it = root_node.rbegin<Preorder>(),
+					end = root_node.rend<Preorder>(); it != end; ++it)
+					it.get_node()->accept(eval_visitor);
+			}
+
+			std::cout << std::endl << "yield of the tree = " << eval_visitor.yield() << std::endl;
+		}
+		catch (Pre_Order_Eval_Visitor<int>::Division_By_Zero &e) {
+			std::cout << std::endl << "yield of the tree = ? (" << e.what() << ")" << std::endl;
+		}
+
+		// Print the statistics the Interpreter kept with the tree.
+		if (options->tree_stats()) {
+			std::cout << std::endl;
+			root_node.stats().print(std::cout);
+		}
+
+		// Print the counts of each phase per node of the tree.
+		if (counters.get() != nullptr && counters->is_available()) {
+			std::cout << std::endl << "phase,event,total,per_node" << std::endl;
+			for (size_t i = 0; i < 3; ++i)
+				counters->print(std::cout, phases[i], samples[i], root_node.stats().nodes_);
+		}
+		else if (counters.get() != nullptr)
+			std::cout << std::endl << "hardware counters are not available" << std::endl;
+	}
+	catch (Workload_Generator::Invalid_Spec &e)
+	{
+		std::cout << "invalid workload spec: " << e.what() << std::endl;
 	}
 	catch (...)
 	{
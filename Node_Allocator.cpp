@@ -0,0 +1,340 @@
+#include "stdafx.h"
+#if !defined (_Node_Allocator_CPP)
+#define _Node_Allocator_CPP
+
+#include <new>
+#include <stdint.h>
+#include <cassert>
+#include <set>
+#include "Node_Allocator.h"
+
+#if defined (_MSC_VER)
+#include <malloc.h>
+#endif
+
+namespace
+{
+	/// Alignment of every node carved from a slab.
+	const size_t ALIGNMENT = 16;
+
+	size_t round_up(size_t size)
+	{
+		return (size + ALIGNMENT - 1) & ~(ALIGNMENT - 1);
+	}
+
+	/// Allocate <size> bytes aligned to <size>, a power of two.
+	void *aligned_allocate(size_t size)
+	{
+#if defined (_MSC_VER)
+		void *ptr = _aligned_malloc(size, size);
+#else
+		void *ptr = nullptr;
+		if (posix_memalign(&ptr, size, size) != 0)
+			ptr = nullptr;
+#endif
+		if (ptr == nullptr)
+			throw std::bad_alloc();
+		return ptr;
+	}
+
+	void aligned_free(void *ptr)
+	{
+#if defined (_MSC_VER)
+		_aligned_free(ptr);
+#else
+		free(ptr);
+#endif
+	}
+
+#if !defined (NDEBUG)
+	/// Slabs in use, for Node_Allocator::owns.  Guarded by the slab
+	/// cache lock.
+	std::set<const void *> &slabs_in_use(void)
+	{
+		static std::set<const void *> slabs;
+		return slabs;
+	}
+#endif
+}
+
+// Header at the start of every slab.
+struct Node_Allocator::Slab
+{
+	std::atomic<long> live_;
+	// Every free subtracts one and the owner adds the number of nodes
+	// it carved when it retires the slab, so this reaches 0 exactly
+	// once: when the slab is retired and all its nodes are freed.
+
+	Slab *next_;
+	// Next slab in <slab_cache_>.
+};
+
+// The calling thread's current slab.
+class Node_Allocator::Thread_Cache
+{
+public:
+	Thread_Cache(void);
+	~Thread_Cache(void);
+
+	Slab *slab_;
+	// Slab being carved, nullptr before the first allocation.
+
+	char *next_;
+	// Next free byte of <slab_>.
+
+	char *end_;
+	// End of <slab_>.
+
+	size_t allocated_;
+	// Nodes carved out of <slab_> so far.
+
+	Node_Allocator_Stats stats_;
+	// Node counters for this thread.
+};
+
+/* statics of the allocator */
+thread_local Node_Allocator::Thread_Cache Node_Allocator::cache_;
+
+std::mutex Node_Allocator::slab_cache_lock_;
+
+Node_Allocator::Slab *Node_Allocator::slab_cache_ = nullptr;
+
+size_t Node_Allocator::slab_cache_count_ = 0;
+
+Atomic_Node_Allocator_Stats Node_Allocator::shared_stats_;
+
+Node_Allocator::Thread_Cache::Thread_Cache(void)
+	:slab_{ nullptr }, next_{ nullptr }, end_{ nullptr }, allocated_{ 0 }, stats_()
+{
+}
+
+// Give up the current slab of an exiting thread and keep its counters.
+Node_Allocator::Thread_Cache::~Thread_Cache(void)
+{
+	if (slab_ != nullptr)
+		retire(slab_, allocated_);
+	shared_stats_.allocations_ += stats_.allocations_;
+	shared_stats_.large_ += stats_.large_;
+	shared_stats_.pins_ += stats_.pins_;
+}
+
+// Allocate <size> bytes from the calling thread's current slab.
+void *
+Node_Allocator::allocate(size_t size)
+{
+	Thread_Cache &cache = cache_;
+
+	if (size > MAX_SIZE) {
+		++cache.stats_.large_;
+		return ::operator new(size);
+	}
+
+	size = round_up(size);
+	if (static_cast<size_t>(cache.end_ - cache.next_) < size) {
+		Slab *slab = new_slab();
+		if (cache.slab_ != nullptr)
+			retire(cache.slab_, cache.allocated_);
+
+		cache.slab_ = slab;
+		cache.next_ = reinterpret_cast<char *>(slab) + round_up(sizeof(Slab));
+		cache.end_ = reinterpret_cast<char *>(slab) + SLAB_SIZE;
+		cache.allocated_ = 0;
+	}
+
+	void *ptr = cache.next_;
+	cache.next_ += size;
+	++cache.allocated_;
+	++cache.stats_.allocations_;
+	return ptr;
+}
+
+// Count the node off its slab.
+void
+Node_Allocator::deallocate(void *ptr, size_t size)
+{
+	if (ptr == nullptr)
+		return;
+
+	if (size > MAX_SIZE) {
+		::operator delete(ptr);
+		return;
+	}
+
+	Slab *slab = slab_of(ptr);
+	if (slab->live_.fetch_sub(1, std::memory_order_acq_rel) == 1)
+		recycle(slab);
+}
+
+// Count a node built in place at <ptr>.  The enclosing node was just
+// allocated on this thread, so its slab is nearly always the current
+// one and the count is kept with <allocated_>.  A retired slab holds
+// the live enclosing node, so adding to <live_> cannot race with it
+// being recycled.
+void
+Node_Allocator::pin(void *ptr)
+{
+	assert(owns(ptr) && "the enclosing node was not allocated from a slab");
+	Thread_Cache &cache = cache_;
+	Slab *slab = slab_of(ptr);
+
+	if (slab == cache.slab_)
+		++cache.allocated_;
+	else
+		slab->live_.fetch_add(1, std::memory_order_acq_rel);
+	++cache.stats_.pins_;
+}
+
+// Look the slab <ptr> would be in up without reading it, since <ptr>
+// may be anywhere.
+bool
+Node_Allocator::owns(void *ptr)
+{
+#if !defined (NDEBUG)
+	Slab *slab = slab_of(ptr);
+	if (reinterpret_cast<char *>(ptr) < reinterpret_cast<char *>(slab) + round_up(sizeof(Slab)))
+		return false;
+	std::lock_guard<std::mutex> guard(slab_cache_lock_);
+	return slabs_in_use().count(slab) != 0;
+#else
+	(void)ptr;
+	return true;
+#endif
+}
+
+// Slabs are aligned to <SLAB_SIZE> so masking the address gives the
+// slab header.
+Node_Allocator::Slab *
+Node_Allocator::slab_of(void *ptr)
+{
+	return reinterpret_cast<Slab *>(
+		reinterpret_cast<uintptr_t>(ptr) & ~static_cast<uintptr_t>(SLAB_SIZE - 1));
+}
+
+// The owner stops allocating from <slab>.
+void
+Node_Allocator::retire(Slab *slab, size_t allocated)
+{
+	const long live = static_cast<long>(allocated);
+	if (slab->live_.fetch_add(live, std::memory_order_acq_rel) + live == 0)
+		recycle(slab);
+}
+
+// Take a slab from the cache or else from the free store.
+Node_Allocator::Slab *
+Node_Allocator::new_slab(void)
+{
+	Slab *slab = nullptr;
+	{
+		std::lock_guard<std::mutex> guard(slab_cache_lock_);
+		if (slab_cache_ != nullptr) {
+			slab = slab_cache_;
+			slab_cache_ = slab->next_;
+			--slab_cache_count_;
+		}
+	}
+
+	if (slab != nullptr)
+		++shared_stats_.slabs_reused_;
+	else {
+		slab = new (aligned_allocate(SLAB_SIZE)) Slab;
+		++shared_stats_.slabs_allocated_;
+	}
+
+	slab->live_.store(0, std::memory_order_relaxed);
+	slab->next_ = nullptr;
+#if !defined (NDEBUG)
+	{
+		std::lock_guard<std::mutex> guard(slab_cache_lock_);
+		slabs_in_use().insert(slab);
+	}
+#endif
+	return slab;
+}
+
+// Put an empty <slab> back in the cache, or free it if the cache holds
+// <SLAB_CACHE_BOUND> slabs already.
+void
+Node_Allocator::recycle(Slab *slab)
+{
+	++shared_stats_.slabs_recycled_;
+	{
+		std::lock_guard<std::mutex> guard(slab_cache_lock_);
+#if !defined (NDEBUG)
+		slabs_in_use().erase(slab);
+#endif
+		if (slab_cache_count_ < SLAB_CACHE_BOUND) {
+			slab->next_ = slab_cache_;
+			slab_cache_ = slab;
+			++slab_cache_count_;
+			return;
+		}
+	}
+
+	++shared_stats_.slabs_released_;
+	aligned_free(slab);
+}
+
+// Give the cached empty slabs back to the free store.
+void
+Node_Allocator::release(void)
+{
+	Slab *slab = nullptr;
+	{
+		std::lock_guard<std::mutex> guard(slab_cache_lock_);
+		slab = slab_cache_;
+		slab_cache_ = nullptr;
+		slab_cache_count_ = 0;
+	}
+
+	while (slab != nullptr) {
+		Slab *next = slab->next_;
+		++shared_stats_.slabs_released_;
+		aligned_free(slab);
+		slab = next;
+	}
+}
+
+// Returns the counters so far.
+Node_Allocator_Stats
+Node_Allocator::stats(void)
+{
+	Node_Allocator_Stats stats = cache_.stats_;
+	stats.allocations_ += shared_stats_.allocations_;
+	stats.large_ += shared_stats_.large_;
+	stats.pins_ += shared_stats_.pins_;
+	stats.slabs_allocated_ = shared_stats_.slabs_allocated_;
+	stats.slabs_reused_ = shared_stats_.slabs_reused_;
+	stats.slabs_recycled_ = shared_stats_.slabs_recycled_;
+	stats.slabs_released_ = shared_stats_.slabs_released_;
+	return stats;
+}
+
+// Print the counters one per line.
+void
+Node_Allocator::print_stats(std::ostream &output)
+{
+	Node_Allocator_Stats s = stats();
+	output << "node_allocations," << s.allocations_ << std::endl
+		<< "large_node_allocations," << s.large_ << std::endl
+		<< "immediate_nodes," << s.pins_ << std::endl
+		<< "slabs_allocated," << s.slabs_allocated_ << std::endl
+		<< "slabs_reused," << s.slabs_reused_ << std::endl
+		<< "slabs_recycled," << s.slabs_recycled_ << std::endl
+		<< "slabs_released," << s.slabs_released_ << std::endl;
+}
+
+// Returns the bytes a node of <size> takes up.
+size_t
+Node_Allocator::allocated_size(size_t size)
+{
+	return size > MAX_SIZE ? size : round_up(size);
+}
+
+// Returns the size of the slab header.
+size_t
+Node_Allocator::slab_header_size(void)
+{
+	return round_up(sizeof(Slab));
+}
+
+#endif /* _Node_Allocator_CPP */
@@ -0,0 +1,152 @@
+#pragma once
+#ifndef _Node_Allocator_H
+#define _Node_Allocator_H
+
+// This header defines "size_t"
+#include <stdlib.h>
+#include <iostream>
+#include <atomic>
+#include <mutex>
+
+// Counters describing how <Component_Node> allocations were served.
+struct Node_Allocator_Stats
+{
+	size_t allocations_;
+	// Nodes carved out of slabs.
+
+	size_t large_;
+	// Nodes above <Node_Allocator::MAX_SIZE>, sent to ::operator new.
+
+	size_t pins_;
+	// Nodes built in place inside another node, see <pin>.
+
+	size_t slabs_allocated_;
+	// Slabs taken from the free store.
+
+	size_t slabs_reused_;
+	// Slabs taken from the cache of empty slabs.
+
+	size_t slabs_recycled_;
+	// Slabs whose nodes had all been freed, put back in the cache.
+
+	size_t slabs_released_;
+	// Empty slabs given back to the free store.
+};
+
+// <Node_Allocator_Stats> that threads can add to concurrently.
+struct Atomic_Node_Allocator_Stats
+{
+	std::atomic<size_t> allocations_;
+	std::atomic<size_t> large_;
+	std::atomic<size_t> pins_;
+	std::atomic<size_t> slabs_allocated_;
+	std::atomic<size_t> slabs_reused_;
+	std::atomic<size_t> slabs_recycled_;
+	std::atomic<size_t> slabs_released_;
+};
+
+/**
+* @class Node_Allocator
+* @brief Slab allocator behind the class specific operator new and
+*        delete of every <Component_Node>.
+*
+*        Each thread carves its nodes, whatever their size, one after
+*        the other out of its current <SLAB_SIZE> slab, so building a
+*        tree of a million nodes asks the free store for a few hundred
+*        slabs instead of a million nodes.  Freeing a node only counts
+*        it off its slab.  A slab whose nodes are all freed goes back
+*        whole to a shared cache of empty slabs, so when a tree dies
+*        its memory is reclaimed a slab at a time.  Slabs are aligned
+*        to their size, which is how a node finds its slab.
+*
+*        The price is that one long lived node keeps its whole slab
+*        from being reused.
+*/
+class Node_Allocator
+{
+public:
+	static void *allocate(size_t size);
+	// Allocate <size> bytes from the calling thread's current slab,
+	// starting a new slab when it is full.  No locks are taken except
+	// when a slab is taken from the cache.
+
+	static void deallocate(void *ptr, size_t size);
+	// Free the <size> bytes at <ptr>, which may have been allocated on
+	// another thread.
+
+	static void pin(void *ptr);
+	// Count a node built in place at <ptr>, inside a node allocated
+	// here that is still being constructed, as one more node of that
+	// slab.  Its deallocate then only drops this count, and the slab
+	// stays in use until it does, even after the enclosing node is
+	// freed.  <ptr> must lie in a slab: the count is written to the
+	// header found by masking its address, so a node on the stack or
+	// from ::operator new would have other memory overwritten.  Debug
+	// builds assert <owns>.
+
+	static bool owns(void *ptr);
+	// Returns true if <ptr> lies in a slab that is in use.  Only debug
+	// builds (without NDEBUG) keep track of the slabs; others always
+	// return true.
+
+	static void release(void);
+	// Give the cached empty slabs back to the free store.
+
+	static Node_Allocator_Stats stats(void);
+	// Returns the counters of the calling thread added to those of all
+	// threads that have already exited and the shared slab counters.
+
+	static void print_stats(std::ostream &output);
+	// Print <stats> one "name,value" line per counter.
+
+	static size_t allocated_size(size_t size);
+	// Returns the bytes a node of <size> takes up: rounded up to the
+	// slab alignment, or <size> itself above <MAX_SIZE>.
+
+	static size_t slab_header_size(void);
+	// Returns the bytes at the start of each slab that hold no nodes.
+
+	static const size_t SLAB_SIZE = 64 * 1024;
+	// Size and alignment of a slab.
+
+	static const size_t MAX_SIZE = 256;
+	// Largest node served from a slab.
+
+	static const size_t SLAB_CACHE_BOUND = 64;
+	// Most empty slabs kept for reuse.
+
+private:
+	struct Slab;
+	class Thread_Cache;
+
+	static Slab *new_slab(void);
+	// Take a slab from the cache or else from the free store.
+
+	static void recycle(Slab *slab);
+	// Put an empty <slab> back in the cache or free it.
+
+	static Slab *slab_of(void *ptr);
+	// Returns the slab holding <ptr>.
+
+	static void retire(Slab *slab, size_t allocated);
+	// The owning thread stops allocating from <slab> after carving
+	// <allocated> nodes out of it.
+
+	static thread_local Thread_Cache cache_;
+	// The calling thread's current slab, used without synchronization.
+
+	static std::mutex slab_cache_lock_;
+	// Serializes access to <slab_cache_>.
+
+	static Slab *slab_cache_;
+	// Empty slabs kept for reuse, linked through <next_>.
+
+	static size_t slab_cache_count_;
+	// Number of slabs in <slab_cache_>.
+
+	static Atomic_Node_Allocator_Stats shared_stats_;
+	// Slab counters, and the node counters of the threads that have
+	// exited.
+};
+
+#endif /* _Node_Allocator_H */
@@ -0,0 +1,71 @@
+#pragma once
+#ifndef _Node_Child_H
+#define _Node_Child_H
+
+#include <type_traits>
+#include "Component_Node.h"
+#include "Leaf_Node.h"
+#include "Node_Allocator.h"
+
+/**
+* @class Node_Child
+* @brief A child handed to the constructor of a composite node: either
+*        a node the composite takes over, or the item of an immediate
+*        leaf.
+*
+*        An immediate leaf is built in place inside the composite, in
+*        its <Storage>, rather than allocated on its own.  It is still
+*        an ordinary Leaf_Node, so left(), right(), Tree handles,
+*        iterators and visitors cannot tell it apart.  It pins the
+*        composite's slab (see Node_Allocator::pin), so a Tree handle
+*        to it stays valid after its parent is destroyed, and deleting
+*        it just drops the pin.  Composites with immediate children
+*        must therefore be created with new.
+*/
+template <typename T>
+class Node_Child
+{
+public:
+	/// Raw storage for an immediate leaf inside a composite.
+	typedef typename std::aligned_storage<sizeof(Leaf_Node<T>),
+		std::alignment_of<Leaf_Node<T> >::value>::type Storage;
+
+	/// Ctor - the composite takes over <node>.
+	Node_Child(Component_Node<T> *node = 0)
+		:node_{ node }, immediate_{ false }, item_(), variable_{ 0 }
+	{}
+
+	/// Return a child that is an immediate leaf holding <item>, the
+	/// value of the variable with id <variable> if it is not 0.
+	static Node_Child<T> immediate(const T &item, int variable = 0) {
+		Node_Child<T> child;
+		child.immediate_ = true;
+		child.item_ = item;
+		child.variable_ = variable;
+		return child;
+	}
+
+	/// Return the child node, building an immediate leaf in <storage>
+	/// first if this is one.
+	Component_Node<T> *place(Storage &storage) const {
+		if (!immediate_)
+			return node_;
+		Node_Allocator::pin(&storage);
+		return new (&storage) Leaf_Node<T>(item_, variable_);
+	}
+
+private:
+	/// Node taken over, if not immediate.
+	Component_Node<T> *node_;
+
+	/// True for an immediate leaf.
+	bool immediate_;
+
+	/// Item of the immediate leaf.
+	T item_;
+
+	/// Variable id of the immediate leaf.
+	int variable_;
+};
+
+#endif /* _Node_Child_H */
@@ -0,0 +1,185 @@
+#include "stdafx.h"
+#if !defined (_Node_Reclaimer_CPP)
+#define _Node_Reclaimer_CPP
+
+#include <algorithm>
+#include <cstdlib>
+#include "Node_Reclaimer.h"
+
+template <typename T> thread_local Inline_Stack<Component_Node<T> *> *
+Node_Reclaimer<T>::worklist_{ nullptr };
+
+// Method to return the one and only instance.  It is never deleted so
+// trees dropped during static destruction can still be reclaimed.
+template <typename T>
+Node_Reclaimer<T> *
+Node_Reclaimer<T>::instance(void)
+{
+	static Node_Reclaimer<T> *reclaimer = new Node_Reclaimer<T>;
+	return reclaimer;
+}
+
+// Ctor
+template <typename T>
+Node_Reclaimer<T>::Node_Reclaimer(void)
+	:in_progress_{ 0 }, running_{ false }, stopping_{ false },
+	deferred_{ 0 }, destroyed_{ 0 }, max_backlog_{ 0 }
+{
+}
+
+// Start or stop the background thread.
+template <typename T>
+void
+Node_Reclaimer<T>::background(bool on)
+{
+	static std::once_flag registered;
+
+	std::unique_lock<std::mutex> guard(lock_);
+	if (on == running_)
+		return;
+
+	if (on) {
+		std::call_once(registered, [] { std::atexit(&Node_Reclaimer<T>::stop_at_exit); });
+		stopping_ = false;
+		running_ = true;
+		thread_ = std::thread(&Node_Reclaimer<T>::run, this);
+	}
+	else {
+		// New retires go inline from here on, the thread drains the rest.
+		running_ = false;
+		stopping_ = true;
+		work_ready_.notify_one();
+		guard.unlock();
+		thread_.join();
+	}
+}
+
+// Returns true while the background thread is running.
+template <typename T>
+bool
+Node_Reclaimer<T>::is_background(void) const
+{
+	return running_;
+}
+
+// The last handle to <node> was dropped.
+template <typename T>
+void
+Node_Reclaimer<T>::retire(Component_Node<T> *node)
+{
+	// <running_> is checked again under the lock, the first check only
+	// keeps the lock off the path when there is no background thread.
+	if ((node->left() != nullptr || node->right() != nullptr)
+		&& running_.load(std::memory_order_relaxed)) {
+		std::unique_lock<std::mutex> guard(lock_);
+		if (running_) {
+			pending_.push_back(node);
+			max_backlog_ = std::max(max_backlog_, pending_.size());
+			++deferred_;
+			guard.unlock();
+			work_ready_.notify_one();
+			return;
+		}
+	}
+
+	destroy(node);
+}
+
+// A parent drops its reference to <child>.
+template <typename T>
+void
+Node_Reclaimer<T>::release(Component_Node<T> *child)
+{
+	if (--child->use_ == 0)
+		destroy(child);
+}
+
+// Delete <node> and every node only it refers to.  Each delete runs
+// the composite destructors, which release the children; the children
+// that die are pushed here instead of being deleted inside them.
+template <typename T>
+void
+Node_Reclaimer<T>::destroy(Component_Node<T> *node)
+{
+	if (worklist_ != nullptr) {
+		worklist_->push(node);
+		return;
+	}
+
+	Inline_Stack<Component_Node<T> *> worklist;
+	worklist.push(node);
+	worklist_ = &worklist;
+
+	size_t count = 0;
+	while (!worklist.empty()) {
+		Component_Node<T> *next = worklist.top();
+		worklist.pop();
+		delete next;
+		++count;
+	}
+
+	worklist_ = nullptr;
+	destroyed_.fetch_add(count, std::memory_order_relaxed);
+}
+
+// Wait until the background thread has caught up.
+template <typename T>
+void
+Node_Reclaimer<T>::flush(void)
+{
+	std::unique_lock<std::mutex> guard(lock_);
+	work_done_.wait(guard, [this] { return pending_.empty() && in_progress_ == 0; });
+}
+
+// Returns the counters so far.
+template <typename T>
+Reclaimer_Stats
+Node_Reclaimer<T>::stats(void) const
+{
+	Reclaimer_Stats stats;
+	stats.destroyed_ = destroyed_;
+
+	std::lock_guard<std::mutex> guard(lock_);
+	stats.deferred_ = deferred_;
+	stats.max_backlog_ = max_backlog_;
+	return stats;
+}
+
+// Body of the background thread.  Takes the whole backlog at once so
+// producers hold the lock only for a push.
+template <typename T>
+void
+Node_Reclaimer<T>::run(void)
+{
+	std::vector<Component_Node<T> *> batch;
+
+	std::unique_lock<std::mutex> guard(lock_);
+	for (;;) {
+		work_ready_.wait(guard, [this] { return !pending_.empty() || stopping_; });
+		if (pending_.empty())
+			break;
+
+		batch.swap(pending_);
+		in_progress_ = batch.size();
+		guard.unlock();
+
+		for (size_t i = 0; i < batch.size(); ++i)
+			destroy(batch[i]);
+		batch.clear();
+
+		guard.lock();
+		in_progress_ = 0;
+		work_done_.notify_all();
+	}
+	work_done_.notify_all();
+}
+
+// Join the background thread before the program exits.
+template <typename T>
+void
+Node_Reclaimer<T>::stop_at_exit(void)
+{
+	instance()->background(false);
+}
+
+#endif /* _Node_Reclaimer_CPP */
@@ -0,0 +1,134 @@
+#pragma once
+#ifndef _Node_Reclaimer_H
+#define _Node_Reclaimer_H
+
+// This header defines "size_t"
+#include <stdlib.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "Component_Node.h"
+#include "Refcounter.h"
+#include "Inline_Stack.h"
+
+// Counters describing how dead <Component_Nodes> were destroyed.
+struct Reclaimer_Stats
+{
+	size_t deferred_;
+	// Trees handed to the background thread.
+
+	size_t destroyed_;
+	// Nodes deleted, on any thread.
+
+	size_t max_backlog_;
+	// Most trees ever waiting for the background thread.
+};
+
+/**
+* @class Node_Reclaimer
+* @brief Destroys expression trees once their last handle is dropped.
+*
+*        Trees are torn down with an explicit worklist rather than by
+*        the auto_ptr children deleting each other recursively, so the
+*        depth of a tree no longer bounds the stack it needs.  A parent
+*        only drops its reference to a child; the child is deleted when
+*        that was the last one, so a Tree handle to a subtree keeps the
+*        subtree alive after its parent is gone.
+*
+*        In background mode the root of a dead tree is handed to a
+*        reclamation thread instead and the thread that dropped the
+*        last handle returns at once.  Reference counts are not atomic,
+*        so no other thread may then hold handles to any of its nodes.
+*        Single nodes are always deleted inline since that costs no
+*        more than handing them over.
+*/
+template <typename T>
+class Node_Reclaimer
+{
+public:
+	/// Method to return the one and only instance.
+	static Node_Reclaimer<T> *instance(void);
+
+	/// Start (<on> true) or stop the background thread.  Stopping
+	/// destroys every tree still waiting before it returns.
+	void background(bool on);
+
+	/// Returns true while the background thread is running.
+	bool is_background(void) const;
+
+	/// The last handle to <node> was dropped.  Called by Refcounter.
+	void retire(Component_Node<T> *node);
+
+	/// A parent drops its reference to <child>.  Called by the
+	/// composite nodes' destructors.
+	void release(Component_Node<T> *child);
+
+	/// Wait until the background thread has destroyed every tree
+	/// handed to it so far.
+	void flush(void);
+
+	/// Returns the counters so far.
+	Reclaimer_Stats stats(void) const;
+
+private:
+	/// Ctor - private for a singleton.
+	Node_Reclaimer(void);
+
+	/// Copying is not supported.
+	Node_Reclaimer(const Node_Reclaimer<T> &);
+	void operator= (const Node_Reclaimer<T> &);
+
+	/// Delete <node> and every node only it refers to on the calling
+	/// thread.  Nested calls, made from the destructors of the nodes
+	/// being deleted, just add to the running worklist.
+	void destroy(Component_Node<T> *node);
+
+	/// Body of the background thread.
+	void run(void);
+
+	/// Registered with atexit so the thread is joined before exit.
+	static void stop_at_exit(void);
+
+	/// Worklist of the destroy running on this thread, nullptr when
+	/// none is.
+	static thread_local Inline_Stack<Component_Node<T> *> *worklist_;
+
+	/// Roots waiting for the background thread.
+	std::vector<Component_Node<T> *> pending_;
+
+	/// Roots the background thread is destroying right now.
+	size_t in_progress_;
+
+	mutable std::mutex lock_;
+	std::condition_variable work_ready_;
+	std::condition_variable work_done_;
+
+	std::thread thread_;
+	std::atomic<bool> running_;
+	bool stopping_;
+
+	size_t deferred_;
+	std::atomic<size_t> destroyed_;
+	size_t max_backlog_;
+};
+
+/**
+* @class Refcounter_Traits<Component_Node<T> >
+* @brief Sends the nodes Refcounter lets go of to the Node_Reclaimer.
+*/
+template <typename T>
+struct Refcounter_Traits<Component_Node<T> >
+{
+	static void dispose(Component_Node<T> *node)
+	{
+		Node_Reclaimer<T>::instance()->retire(node);
+	}
+};
+
+#include "Node_Reclaimer.cpp"
+
+#endif /* _Node_Reclaimer_H */
@@ -4,6 +4,7 @@
 
 #include <iostream>
 #include <cstdio>
+#include <algorithm>
 
 #include "Options.h"
 #include "getopt.h"
@@ -28,7 +29,18 @@ Options::instance()
 // Ctor
 Options::Options()
 	: traversal_strategy_("Levelorder"),
-	queue_type_("LQueue")
+	queue_type_("LQueue"),
+	benchmark_terms_(0),
+	benchmark_repetitions_(5),
+	benchmark_warmup_(1),
+	workload_spec_(),
+	pipeline_(false),
+	background_reclaim_(false),
+	dump_counters_(false),
+	trace_file_(),
+	hardware_counters_(false),
+	latency_histograms_(false),
+	tree_stats_(false)
 {
 }
 
@@ -49,6 +61,13 @@ Options::queue_type()
 	return queue_type_;
 }
 
+// Set queue type.
+void
+Options::set_queue_type(const std::string &queue_type)
+{
+	queue_type_ = queue_type;
+}
+
 // Return traversal strategy.
 std::string
 Options::traversal_strategy()
@@ -56,13 +75,90 @@ Options::traversal_strategy()
 	return traversal_strategy_;
 }
 
+// Return number of benchmark operands.
+size_t
+Options::benchmark_terms()
+{
+	return benchmark_terms_;
+}
+
+// Return number of timed benchmark runs.
+size_t
+Options::benchmark_repetitions()
+{
+	return benchmark_repetitions_;
+}
+
+// Return number of untimed benchmark runs.
+size_t
+Options::benchmark_warmup()
+{
+	return benchmark_warmup_;
+}
+
+// Return the spec of the expressions to generate.
+std::string
+Options::workload_spec()
+{
+	return workload_spec_;
+}
+
+// Return whether the pipeline was requested.
+bool
+Options::pipeline()
+{
+	return pipeline_;
+}
+
+// Return whether trees should be reclaimed in the background.
+bool
+Options::background_reclaim()
+{
+	return background_reclaim_;
+}
+
+// Return whether the hot path counters should be printed at exit.
+bool
+Options::dump_counters()
+{
+	return dump_counters_;
+}
+
+// Return the file to write the phase trace to.
+std::string
+Options::trace_file()
+{
+	return trace_file_;
+}
+
+// Return whether the hardware counters should be read.
+bool
+Options::hardware_counters()
+{
+	return hardware_counters_;
+}
+
+// Return whether the expression latencies should be kept.
+bool
+Options::latency_histograms()
+{
+	return latency_histograms_;
+}
+
+// Return whether the tree statistics should be printed.
+bool
+Options::tree_stats()
+{
+	return tree_stats_;
+}
+
 // Parse the command line arguments.
 bool
 Options::parse_args(int argc, char *argv[])
 {
 	// You may need to use the getopt() function in the assignment4 directory.
 	for (int c;
-		(c = parsing::getopt(argc, argv, "t:q:h?")) != EOF;
+		(c = parsing::getopt(argc, argv, "t:q:b:n:w:g:prcj:elsh?")) != EOF;
 		)
 		switch (c)
 		{
@@ -91,9 +187,66 @@ Options::parse_args(int argc, char *argv[])
 			break;
 			// Parse the queue type option
 		case 'q':
-			this->queue_type_ = parsing::optarg[0] == 'L'
-				? "LQueue"
-				: "STLQueue";
+			switch (parsing::optarg[0])
+			{
+				// Linked list queue
+			case 'L':
+				this->queue_type_ = "LQueue";
+				break;
+				// Array based ring buffer
+			case 'A':
+				this->queue_type_ = "AQueue";
+				break;
+				// std::queue
+			case 'S':
+			default:
+				this->queue_type_ = "STLQueue";
+				break;
+			}
+			break;
+			// Parse the benchmark size option
+		case 'b':
+			this->benchmark_terms_ = atoi(parsing::optarg);
+			break;
+			// Parse the benchmark repetitions option
+		case 'n':
+			this->benchmark_repetitions_ = std::max(atoi(parsing::optarg), 1);
+			break;
+			// Parse the benchmark warmup option
+		case 'w':
+			this->benchmark_warmup_ = std::max(atoi(parsing::optarg), 0);
+			break;
+			// Parse the workload generator option
+		case 'g':
+			this->workload_spec_ = parsing::optarg;
+			break;
+			// Parse the pipeline option
+		case 'p':
+			this->pipeline_ = true;
+			break;
+			// Parse the background reclamation option
+		case 'r':
+			this->background_reclaim_ = true;
+			break;
+			// Parse the counters option
+		case 'c':
+			this->dump_counters_ = true;
+			break;
+			// Parse the trace file option
+		case 'j':
+			this->trace_file_ = parsing::optarg;
+			break;
+			// Parse the hardware counters option
+		case 'e':
+			this->hardware_counters_ = true;
+			break;
+			// Parse the latency histograms option
+		case 'l':
+			this->latency_histograms_ = true;
+			break;
+			// Parse the tree statistics option
+		case 's':
+			this->tree_stats_ = true;
 			break;
 		case 'h':
 		case '?':
@@ -111,7 +264,7 @@ Options::parse_args(int argc, char *argv[])
 void
 Options::print_usage(void)
 {
-	std::cout << "Usage: Adapter_test [-t L|p|P|I] [-q S|L]" << std::endl;
+	std::cout << "Usage: Adapter_test [-t L|p|P|I] [-q S|L|A] [-b terms] [-n runs] [-w runs] [-g spec] [-p] [-r] [-c] [-j file] [-e] [-l] [-s]" << std::endl;
 	std::cout << "    where -t specifies the tree traversal strategy:" << std::endl;
 	std::cout << "       L = Levelorder (default)" << std::endl;
 	std::cout << "       P = Preorder" << std::endl;
@@ -120,6 +273,32 @@ Options::print_usage(void)
 	std::cout << "    where -q specifies the queue type:" << std::endl;
 	std::cout << "       L = LQueue (default)" << std::endl;
 	std::cout << "       S = STLQueue" << std::endl;
+	std::cout << "       A = AQueue" << std::endl << std::endl;
+	std::cout << "    where -b runs the benchmarks on an expression with" << std::endl;
+	std::cout << "       the given number of operands and exits" << std::endl << std::endl;
+	std::cout << "    where -n times each benchmark the given number of" << std::endl;
+	std::cout << "       times (default 5)" << std::endl << std::endl;
+	std::cout << "    where -w runs each benchmark the given number of" << std::endl;
+	std::cout << "       times before timing it (default 1)" << std::endl << std::endl;
+	std::cout << "    where -g prints generated expressions and exits, the" << std::endl;
+	std::cout << "       spec is key=value pairs separated by commas:" << std::endl;
+	std::cout << "       operands=N depth=N shape=left|right|random|balanced" << std::endl;
+	std::cout << "       ops=+4-4*4/4~1 parens=P variables=N variable_rate=P" << std::endl;
+	std::cout << "       seed=N count=N" << std::endl << std::endl;
+	std::cout << "    where -p evaluates every line of standard input with" << std::endl;
+	std::cout << "       separate read, build and evaluate threads" << std::endl << std::endl;
+	std::cout << "    where -r destroys dead trees on a background thread" << std::endl << std::endl;
+	std::cout << "    where -c prints the hot path counters at exit, when" << std::endl;
+	std::cout << "       built with HOT_PATH_COUNTERS" << std::endl << std::endl;
+	std::cout << "    where -j writes a trace of the processing phases to" << std::endl;
+	std::cout << "       the given file at exit, as Chrome trace event JSON" << std::endl << std::endl;
+	std::cout << "    where -e reads the hardware counters around each timed" << std::endl;
+	std::cout << "       benchmark, or around each phase of the test, on Linux" << std::endl << std::endl;
+	std::cout << "    where -l prints the parse, build and evaluate latency" << std::endl;
+	std::cout << "       percentiles of the expressions at exit, and so far" << std::endl;
+	std::cout << "       to standard error on SIGUSR1 while -p runs" << std::endl << std::endl;
+	std::cout << "    where -s prints the node counts, height, width and" << std::endl;
+	std::cout << "       memory footprint of the test's tree" << std::endl;
 }
 
 #endif /* _OptionsXS_CPP */
\ No newline at end of file
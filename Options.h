@@ -23,14 +23,72 @@ public:
 	/// This returns the queue type specified on the command line.
 	std::string queue_type();
 
+	/// Make <queue_type> ("LQueue", "AQueue" or "STLQueue") the queue
+	/// used by the level order iterators created from now on.
+	void set_queue_type(const std::string &queue_type);
+
 	/// This returns the traversal strategy specified on the command line.
 	std::string traversal_strategy();
 
+	/// This returns the number of operands of the benchmark expression,
+	/// 0 unless benchmarks were requested on the command line.
+	size_t benchmark_terms();
+
+	/// This returns the number of timed runs of each benchmark.
+	size_t benchmark_repetitions();
+
+	/// This returns the number of untimed runs of each benchmark
+	/// before the timed ones.
+	size_t benchmark_warmup();
+
+	/// This returns the spec of the expressions to generate, empty unless
+	/// generating was requested on the command line.
+	std::string workload_spec();
+
+	/// This returns true if the expressions on standard input should be
+	/// evaluated by the multi-threaded Pipeline.
+	bool pipeline();
+
+	/// This returns true if dead trees should be destroyed by a
+	/// background thread.
+	bool background_reclaim();
+
+	/// This returns true if the Hot_Counters should be printed at exit.
+	bool dump_counters();
+
+	/// This returns the file the Phase_Tracer should write its trace
+	/// to at exit, empty unless tracing was requested.
+	std::string trace_file();
+
+	/// This returns true if the hardware performance counters should be
+	/// read around the measured phases.
+	bool hardware_counters();
+
+	/// This returns true if the latency of each expression should be
+	/// kept and its percentiles printed.
+	bool latency_histograms();
+
+	/// This returns true if the Tree_Stats of the tree should be printed.
+	bool tree_stats();
+
 	/// Parse command-line arguments and set the appropriate values as
 	/// follows:
 	/// 't' - Traversal strategy, i.e., 'P' for pre-order, 'O' for
 	/// post-order, 'I' for in-order, and 'L' for level-order.
-	/// 'q' - Type of queue, i.e., either 'L' for LQeuue or 'A' for AQueue.
+	/// 'q' - Type of queue, i.e., 'L' for LQeuue, 'A' for AQueue or 'S'
+	/// for STLQueue.
+	/// 'b' - Run the benchmarks on an expression with this many operands.
+	/// 'n' - Time each benchmark this many times.
+	/// 'w' - Run each benchmark this many times before timing it.
+	/// 'g' - Print generated expressions, one per line, described by
+	/// this Workload_Generator spec.
+	/// 'p' - Evaluate every line of standard input with the Pipeline.
+	/// 'r' - Destroy dead trees on a background thread.
+	/// 'c' - Print the Hot_Counters at exit.
+	/// 'j' - Trace the processing phases into this file.
+	/// 'e' - Read the hardware counters around the measured phases.
+	/// 'l' - Print the latency percentiles at exit and on SIGUSR1.
+	/// 's' - Print the Tree_Stats of the tree.
 	bool parse_args(int argc, char *argv[]);
 
 	/// Print out usage and default values.
@@ -43,6 +101,17 @@ private:
 	/// Values for parameters passed in on the command line.
 	std::string traversal_strategy_;
 	std::string queue_type_;
+	size_t benchmark_terms_;
+	size_t benchmark_repetitions_;
+	size_t benchmark_warmup_;
+	std::string workload_spec_;
+	bool pipeline_;
+	bool background_reclaim_;
+	bool dump_counters_;
+	std::string trace_file_;
+	bool hardware_counters_;
+	bool latency_histograms_;
+	bool tree_stats_;
 
 	/// Pointer to the one and only Options object
 	static Options* options_impl_;
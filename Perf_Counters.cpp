@@ -0,0 +1,175 @@
+#include "stdafx.h"
+#if !defined (_Perf_Counters_CPP)
+#define _Perf_Counters_CPP
+
+#include <iomanip>
+#include "Perf_Counters.h"
+
+#if defined (__linux__)
+#include <cstring>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+#endif
+
+namespace
+{
+	/// Names of the events in <Perf_Event> order.
+	const char *event_names[PERF_EVENT_COUNT] = {
+		"cycles",
+		"instructions",
+		"l1d_misses",
+		"llc_misses",
+		"branch_misses"
+	};
+
+#if defined (__linux__)
+	/// Open one user space event of the calling thread and the threads
+	/// it starts, stopped.  Returns -1 if it cannot be counted.
+	int open_event(uint32_t type, uint64_t config)
+	{
+		perf_event_attr attr;
+		std::memset(&attr, 0, sizeof attr);
+		attr.size = sizeof attr;
+		attr.type = type;
+		attr.config = config;
+		attr.disabled = 1;
+		attr.inherit = 1;
+		attr.exclude_kernel = 1;
+		attr.exclude_hv = 1;
+		attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+		return static_cast<int>(syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0));
+	}
+
+	/// Read the count, time enabled and time running of the event
+	/// <fd> into <values>.  Returns false if it cannot be read.
+	bool read_event(int fd, uint64_t values[3])
+	{
+		return read(fd, values, 3 * sizeof *values) == static_cast<ssize_t>(3 * sizeof *values);
+	}
+
+	/// Returns the config of a cache read miss event of <cache>.
+	uint64_t cache_miss(uint64_t cache)
+	{
+		return cache
+			| (PERF_COUNT_HW_CACHE_OP_READ << 8)
+			| (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+	}
+#endif
+}
+
+// Open every event.
+Perf_Counters::Perf_Counters(void)
+{
+	for (size_t i = 0; i < PERF_EVENT_COUNT; ++i) {
+		fds_[i] = -1;
+		started_[i][0] = started_[i][1] = started_[i][2] = 0;
+	}
+
+#if defined (__linux__)
+	fds_[PERF_CYCLES] = open_event(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES);
+	fds_[PERF_INSTRUCTIONS] = open_event(PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS);
+	fds_[PERF_L1D_MISSES] = open_event(PERF_TYPE_HW_CACHE, cache_miss(PERF_COUNT_HW_CACHE_L1D));
+	fds_[PERF_LLC_MISSES] = open_event(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES);
+	fds_[PERF_BRANCH_MISSES] = open_event(PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES);
+#endif
+}
+
+// Close every event.
+Perf_Counters::~Perf_Counters(void)
+{
+#if defined (__linux__)
+	for (size_t i = 0; i < PERF_EVENT_COUNT; ++i)
+		if (fds_[i] != -1)
+			close(fds_[i]);
+#endif
+}
+
+// Returns true if <event> could be opened.
+bool
+Perf_Counters::is_open(Perf_Event event) const
+{
+	return fds_[event] != -1;
+}
+
+// Returns true if any event could be opened.
+bool
+Perf_Counters::is_available(void) const
+{
+	for (size_t i = 0; i < PERF_EVENT_COUNT; ++i)
+		if (fds_[i] != -1)
+			return true;
+	return false;
+}
+
+// Remember the counts so far and start counting.
+void
+Perf_Counters::start(void)
+{
+#if defined (__linux__)
+	for (size_t i = 0; i < PERF_EVENT_COUNT; ++i)
+		if (fds_[i] != -1 && !read_event(fds_[i], started_[i]))
+			started_[i][0] = started_[i][1] = started_[i][2] = 0;
+
+	for (size_t i = 0; i < PERF_EVENT_COUNT; ++i)
+		if (fds_[i] != -1)
+			ioctl(fds_[i], PERF_EVENT_IOC_ENABLE, 0);
+#endif
+}
+
+// Stop counting and return the counts since start, scaled up by the
+// share of the time each event was actually on the hardware.
+Perf_Sample
+Perf_Counters::stop(void)
+{
+	Perf_Sample sample;
+	for (size_t i = 0; i < PERF_EVENT_COUNT; ++i)
+		sample.counts_[i] = 0;
+
+#if defined (__linux__)
+	for (size_t i = 0; i < PERF_EVENT_COUNT; ++i)
+		if (fds_[i] != -1)
+			ioctl(fds_[i], PERF_EVENT_IOC_DISABLE, 0);
+
+	for (size_t i = 0; i < PERF_EVENT_COUNT; ++i) {
+		uint64_t values[3];
+		if (fds_[i] == -1 || !read_event(fds_[i], values))
+			continue;
+
+		const uint64_t count = values[0] - started_[i][0];
+		const uint64_t enabled = values[1] - started_[i][1];
+		const uint64_t running = values[2] - started_[i][2];
+		if (running != 0 && running < enabled)
+			sample.counts_[i] = static_cast<uint64_t>(static_cast<double>(count) * enabled / running);
+		else
+			sample.counts_[i] = count;
+	}
+#endif
+
+	return sample;
+}
+
+// Print the open events one per line.
+void
+Perf_Counters::print(std::ostream &output, const std::string &phase,
+	const Perf_Sample &sample, size_t items) const
+{
+	for (size_t i = 0; i < PERF_EVENT_COUNT; ++i) {
+		if (fds_[i] == -1)
+			continue;
+		output << phase << "," << event_names[i] << "," << sample.counts_[i] << ","
+			<< std::fixed << std::setprecision(2)
+			<< static_cast<double>(sample.counts_[i]) / (items ? items : 1) << std::endl;
+	}
+}
+
+// Returns the name <event> is printed under.
+const char *
+Perf_Counters::name(Perf_Event event)
+{
+	return event_names[event];
+}
+
+#endif /* _Perf_Counters_CPP */
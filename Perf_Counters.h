@@ -0,0 +1,125 @@
+#pragma once
+#ifndef _Perf_Counters_H
+#define _Perf_Counters_H
+
+// This header defines "size_t"
+#include <stdlib.h>
+#include <stdint.h>
+#include <string>
+#include <iostream>
+
+/// Hardware events read by <Perf_Counters>.
+enum Perf_Event
+{
+	PERF_CYCLES,
+	// CPU cycles.
+
+	PERF_INSTRUCTIONS,
+	// Instructions retired.
+
+	PERF_L1D_MISSES,
+	// Level 1 data cache read misses.
+
+	PERF_LLC_MISSES,
+	// Last level cache misses.
+
+	PERF_BRANCH_MISSES,
+	// Mispredicted branches, virtual calls included.
+
+	PERF_EVENT_COUNT
+};
+
+// Counts of the <Perf_Event>s over one measured phase.
+struct Perf_Sample
+{
+	uint64_t counts_[PERF_EVENT_COUNT];
+	// Indexed by <Perf_Event>, 0 for the events that are not open.
+};
+
+/**
+* @class Perf_Counters
+* @brief Reads the hardware performance counters of the calling thread
+*        around a measured phase, e.g. a traversal or a visitor pass.
+*
+*        The counters are opened with perf_event_open, so they are only
+*        available on Linux, and only where the kernel lets the process
+*        count its own user space events.  Each event is opened on its
+*        own, an event the machine lacks leaves the others working.
+*        Threads started after the counters are opened are counted too.
+*        When the kernel multiplexes the events the counts are scaled
+*        up to the whole phase.
+*/
+class Perf_Counters
+{
+public:
+	/// Ctor - open every event on the calling thread, stopped.
+	Perf_Counters(void);
+
+	/// Dtor
+	~Perf_Counters(void);
+
+	/// Returns true if <event> could be opened.
+	bool is_open(Perf_Event event) const;
+
+	/// Returns true if any event could be opened.
+	bool is_available(void) const;
+
+	/// Start counting.
+	void start(void);
+
+	/// Stop counting and return the counts since start.
+	Perf_Sample stop(void);
+
+	/// Print one "phase,event,total,per_item" line per open event, the
+	/// per item figure taken over <items>.
+	void print(std::ostream &output, const std::string &phase,
+		const Perf_Sample &sample, size_t items) const;
+
+	/// Returns the name <event> is printed under.
+	static const char *name(Perf_Event event);
+
+private:
+	// Copying is not supported.
+	Perf_Counters(const Perf_Counters &);
+	void operator= (const Perf_Counters &);
+
+	int fds_[PERF_EVENT_COUNT];
+	// File descriptor of each event, -1 if it is not open.
+
+	uint64_t started_[PERF_EVENT_COUNT][3];
+	// Count, time enabled and time running of each event at start.
+	// Resetting an event does not reset what exited threads added to
+	// it, so stop subtracts these instead.
+};
+
+/**
+* @class Perf_Span
+* @brief Reads <counters> from its construction to its destruction into
+*        <sample>.  Does nothing if <counters> is nullptr.
+*/
+class Perf_Span
+{
+public:
+	/// Ctor
+	Perf_Span(Perf_Counters *counters, Perf_Sample &sample)
+		:counters_{ counters }, sample_(sample)
+	{
+		if (counters_ != nullptr)
+			counters_->start();
+	}
+
+	/// Dtor
+	~Perf_Span(void) {
+		if (counters_ != nullptr)
+			sample_ = counters_->stop();
+	}
+
+private:
+	/// Counters to read, or nullptr.
+	Perf_Counters *counters_;
+
+	/// Where the counts go.
+	Perf_Sample &sample_;
+};
+
+#endif /* _Perf_Counters_H */
@@ -0,0 +1,271 @@
+#include "stdafx.h"
+#if !defined (_Phase_Tracer_CPP)
+#define _Phase_Tracer_CPP
+
+#include <chrono>
+#include <mutex>
+#include <fstream>
+#include <iomanip>
+#include <cstdlib>
+
+#include "Phase_Tracer.h"
+
+namespace
+{
+	/// Time 0 of the trace.
+	const std::chrono::steady_clock::time_point epoch = std::chrono::steady_clock::now();
+
+	/// Write <text> as a JSON string.
+	void write_string(std::ostream &output, const char *text)
+	{
+		output << '"';
+		for (; *text != '\0'; ++text) {
+			if (*text == '"' || *text == '\\')
+				output << '\\';
+			output << *text;
+		}
+		output << '"';
+	}
+
+	/// Write <nanoseconds> as the microseconds trace events are in,
+	/// leaving the fill character of <output> as it was.
+	void write_microseconds(std::ostream &output, uint64_t nanoseconds)
+	{
+		const char fill = output.fill('0');
+		output << nanoseconds / 1000 << '.'
+			<< std::setw(3) << nanoseconds % 1000;
+		output.fill(fill);
+	}
+}
+
+// One span.
+struct Phase_Tracer::Event
+{
+	const char *name_;
+	uint64_t start_;
+	uint64_t duration_;
+};
+
+// A block of spans of one thread.
+struct Phase_Tracer::Chunk
+{
+	static const size_t SIZE = 4096;
+
+	Chunk(void)
+		:count_{ 0 }, next_{ nullptr }
+	{}
+
+	Event events_[SIZE];
+
+	std::atomic<size_t> count_;
+	// Events filled in, published with a release store.
+
+	std::atomic<Chunk *> next_;
+	// Next chunk, set once this one is full.
+};
+
+// The spans of one thread, appended to by that thread only.
+class Phase_Tracer::Thread_Buffer
+{
+public:
+	Thread_Buffer(size_t id)
+		:id_{ id }, name_{ nullptr }, head_{ new Chunk }, tail_{ head_ },
+		events_{ 0 }, dropped_{ 0 }, next_{ nullptr }
+	{}
+
+	/// Append <event>, or count it as dropped if the buffer is full.
+	void append(const Event &event) {
+		if (events_ == MAX_EVENTS_PER_THREAD) {
+			dropped_.store(dropped_.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+			return;
+		}
+
+		size_t count = tail_->count_.load(std::memory_order_relaxed);
+		if (count == Chunk::SIZE) {
+			Chunk *chunk = new Chunk;
+			tail_->next_.store(chunk, std::memory_order_release);
+			tail_ = chunk;
+			count = 0;
+		}
+		tail_->events_[count] = event;
+		tail_->count_.store(count + 1, std::memory_order_release);
+		++events_;
+	}
+
+	size_t id_;
+	// Thread id in the trace.
+
+	std::atomic<const char *> name_;
+	// Thread name in the trace, or nullptr.
+
+	Chunk *head_;
+	// First chunk, read by write.
+
+	Chunk *tail_;
+	// Chunk being filled, used by the owning thread only.
+
+	size_t events_;
+	// Events appended, used by the owning thread only.
+
+	std::atomic<size_t> dropped_;
+	// Events dropped because the buffer was full.
+
+	Thread_Buffer *next_;
+	// Next buffer in the registry.
+};
+
+// Every thread buffer ever made.
+struct Phase_Tracer::Registry
+{
+	Registry(void)
+		:buffers_{ nullptr }, count_{ 0 }, path_()
+	{}
+
+	std::mutex lock_;
+	// Serializes registering buffers and walking them.
+
+	Thread_Buffer *buffers_;
+	// All buffers, newest first.
+
+	size_t count_;
+	// Number of buffers.
+
+	std::string path_;
+	// File written by write_trace_file.
+};
+
+/* statics of the tracer */
+std::atomic<bool> Phase_Tracer::enabled_{ false };
+
+// Returns the one and only registry.  It is never deleted, so spans
+// recorded during static destruction are still safe.
+Phase_Tracer::Registry *
+Phase_Tracer::registry(void)
+{
+	static Registry *registry = new Registry;
+	return registry;
+}
+
+// Returns the calling thread's buffer.
+Phase_Tracer::Thread_Buffer &
+Phase_Tracer::buffer(void)
+{
+	static thread_local Thread_Buffer *buffer = nullptr;
+	if (buffer == nullptr) {
+		Registry *r = registry();
+		std::lock_guard<std::mutex> guard(r->lock_);
+		buffer = new Thread_Buffer(++r->count_);
+		buffer->next_ = r->buffers_;
+		r->buffers_ = buffer;
+	}
+	return *buffer;
+}
+
+// Start or stop recording.
+void
+Phase_Tracer::enable(bool on)
+{
+	enabled_.store(on, std::memory_order_relaxed);
+}
+
+// Name the calling thread in the trace.
+void
+Phase_Tracer::name_thread(const char *name)
+{
+	if (is_enabled())
+		buffer().name_.store(name, std::memory_order_release);
+}
+
+// Record a span on the calling thread.
+void
+Phase_Tracer::record(const char *name, uint64_t start, uint64_t end)
+{
+	Event event = { name, start, end - start };
+	buffer().append(event);
+}
+
+// Returns the time in nanoseconds since the epoch, never 0 so a span
+// can use 0 for "not recording".
+uint64_t
+Phase_Tracer::now(void)
+{
+	return 1 + std::chrono::duration_cast<std::chrono::nanoseconds>(
+		std::chrono::steady_clock::now() - epoch).count();
+}
+
+// Write every span recorded so far.  Spans recorded while this runs
+// may or may not be included.
+void
+Phase_Tracer::write(std::ostream &output)
+{
+	Registry *r = registry();
+	std::lock_guard<std::mutex> guard(r->lock_);
+
+	size_t dropped = 0;
+	bool first = true;
+	output << "{\"traceEvents\":[";
+
+	for (Thread_Buffer *buffer = r->buffers_; buffer != nullptr; buffer = buffer->next_) {
+		dropped += buffer->dropped_.load(std::memory_order_relaxed);
+
+		if (const char *name = buffer->name_.load(std::memory_order_acquire)) {
+			output << (first ? "\n" : ",\n")
+				<< "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << buffer->id_
+				<< ",\"args\":{\"name\":";
+			write_string(output, name);
+			output << "}}";
+			first = false;
+		}
+
+		for (Chunk *chunk = buffer->head_; chunk != nullptr;
+			chunk = chunk->next_.load(std::memory_order_acquire)) {
+			const size_t count = chunk->count_.load(std::memory_order_acquire);
+			for (size_t i = 0; i < count; ++i) {
+				const Event &event = chunk->events_[i];
+				output << (first ? "\n" : ",\n") << "{\"name\":";
+				write_string(output, event.name_);
+				output << ",\"cat\":\"phase\",\"ph\":\"X\",\"pid\":1,\"tid\":" << buffer->id_ << ",\"ts\":";
+				write_microseconds(output, event.start_);
+				output << ",\"dur\":";
+				write_microseconds(output, event.duration_);
+				output << "}";
+				first = false;
+			}
+		}
+	}
+
+	output << "\n],\"displayTimeUnit\":\"ns\",\"otherData\":{\"dropped_events\":"
+		<< dropped << "}}" << std::endl;
+}
+
+// Write the trace to <path> when the program exits.
+void
+Phase_Tracer::write_at_exit(const std::string &path)
+{
+	static std::once_flag registered;
+
+	{
+		std::lock_guard<std::mutex> guard(registry()->lock_);
+		registry()->path_ = path;
+	}
+	std::call_once(registered, [] { std::atexit(&Phase_Tracer::write_trace_file); });
+}
+
+// Write the trace to the file given to write_at_exit.
+void
+Phase_Tracer::write_trace_file(void)
+{
+	std::string path;
+	{
+		std::lock_guard<std::mutex> guard(registry()->lock_);
+		path = registry()->path_;
+	}
+
+	std::ofstream output(path.c_str());
+	if (output)
+		write(output);
+	else
+		std::cerr << "cannot write the trace to " << path << std::endl;
+}
+
+#endif /* _Phase_Tracer_CPP */
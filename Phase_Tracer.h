@@ -0,0 +1,103 @@
+#pragma once
+#ifndef _Phase_Tracer_H
+#define _Phase_Tracer_H
+
+// This header defines "size_t"
+#include <stdlib.h>
+#include <stdint.h>
+#include <string>
+#include <iostream>
+#include <atomic>
+
+/**
+* @class Phase_Tracer
+* @brief Records timed spans of the processing phases and writes them
+*        as Chrome trace event JSON, which chrome://tracing and the
+*        Perfetto UI display as one timeline per thread.
+*
+*        Each thread records into its own buffer, a list of fixed size
+*        chunks that only that thread appends to, so recording takes no
+*        lock.  A chunk's count is published with a release store, so
+*        write can run at any time, from any thread, while the others
+*        keep recording.  Buffers outlive their threads and are never
+*        freed.  Nothing is recorded until tracing is enabled; a
+*        Trace_Span then costs one relaxed load.
+*/
+class Phase_Tracer
+{
+public:
+	/// Start or stop recording.
+	static void enable(bool on);
+
+	/// Returns true while recording.
+	static bool is_enabled(void) {
+		return enabled_.load(std::memory_order_relaxed);
+	}
+
+	/// Name the calling thread in the trace.  <name> must outlive the
+	/// tracer, e.g. a string literal.
+	static void name_thread(const char *name);
+
+	/// Record the span <name> from <start> to <end>, in nanoseconds of
+	/// <now>, on the calling thread.  <name> must outlive the tracer.
+	static void record(const char *name, uint64_t start, uint64_t end);
+
+	/// Returns the time in nanoseconds since the tracer's epoch.
+	static uint64_t now(void);
+
+	/// Write every span recorded so far as trace event JSON.
+	static void write(std::ostream &output);
+
+	/// Write the trace to the file <path> when the program exits.
+	static void write_at_exit(const std::string &path);
+
+	/// Most spans kept per thread, later ones are counted as dropped.
+	static const size_t MAX_EVENTS_PER_THREAD = 1 << 22;
+
+private:
+	struct Event;
+	struct Chunk;
+	class Thread_Buffer;
+	struct Registry;
+
+	static Registry *registry(void);
+	// Returns the one and only registry of thread buffers.
+
+	static Thread_Buffer &buffer(void);
+	// Returns the calling thread's buffer, registering it first.
+
+	static void write_trace_file(void);
+	// The atexit handler behind write_at_exit.
+
+	static std::atomic<bool> enabled_;
+	// True while recording.
+};
+
+/**
+* @class Trace_Span
+* @brief Records the time from its construction to its destruction as
+*        a span named <name> on the calling thread.
+*/
+class Trace_Span
+{
+public:
+	/// Ctor - <name> must outlive the tracer, e.g. a string literal.
+	Trace_Span(const char *name)
+		:name_{ name }, start_{ Phase_Tracer::is_enabled() ? Phase_Tracer::now() : 0 }
+	{}
+
+	/// Dtor
+	~Trace_Span(void) {
+		if (start_ != 0)
+			Phase_Tracer::record(name_, start_, Phase_Tracer::now());
+	}
+
+private:
+	/// Name of the span.
+	const char *name_;
+
+	/// Start time, 0 if tracing was off.
+	uint64_t start_;
+};
+
+#endif /* _Phase_Tracer_H */
@@ -0,0 +1,224 @@
+#include "stdafx.h"
+#if !defined (_Pipeline_CPP)
+#define _Pipeline_CPP
+
+#include <iomanip>
+#include <thread>
+#include <chrono>
+#include <utility>
+
+#include "Pipeline.h"
+#include "Interpreter.h"
+#include "Eval_Visitor.h"
+#include "Phase_Tracer.h"
+#include "Latency_Histogram.h"
+
+namespace
+{
+	typedef std::chrono::steady_clock Clock;
+
+	double seconds_since(Clock::time_point start)
+	{
+		std::chrono::duration<double> elapsed = Clock::now() - start;
+		return elapsed.count();
+	}
+}
+
+Pipeline::Stage_Stats::Stage_Stats(void)
+	:items_{ 0 }, input_waits_{ 0 }, output_waits_{ 0 },
+	busy_seconds_{ 0 }, occupancy_sum_{ 0 }
+{
+}
+
+// Ctor
+Pipeline::Pipeline(size_t ring_size)
+	:lines_{ ring_size }, trees_{ ring_size }, elapsed_seconds_{ 0 }
+{
+}
+
+// Dtor
+Pipeline::~Pipeline(void)
+{
+}
+
+// Evaluate every non blank line of <input>.  The calling thread reads,
+// the other two stages get a thread each.
+size_t
+Pipeline::run(std::istream &input, std::ostream &output)
+{
+	Clock::time_point start = Clock::now();
+
+	std::thread builder(&Pipeline::build, this);
+	std::thread evaluator(&Pipeline::evaluate, this, std::ref(output));
+
+	read(input);
+
+	builder.join();
+	evaluator.join();
+
+	elapsed_seconds_ = seconds_since(start);
+	return evaluate_stats_.items_;
+}
+
+// Stage 1: read and trim lines and parse them.  The parse tree is
+// handed on to the builder, which frees it.  A line that cannot be
+// parsed goes on with no parse tree, so only it fails.
+void
+Pipeline::read(std::istream &input)
+{
+	Interpreter_Context context;
+	Interpreter interpreter;
+	Phase_Tracer::name_thread("read");
+
+	Job job;
+	for (;;) {
+		Clock::time_point start = Clock::now();
+		{
+			Trace_Span span("read");
+			if (!std::getline(input, job.input_))
+				break;
+
+			std::string::size_type first = job.input_.find_first_not_of(" \t\r\n");
+			if (first == std::string::npos)
+				continue;
+			std::string::size_type last = job.input_.find_last_not_of(" \t\r\n");
+			job.input_ = job.input_.substr(first, last - first + 1);
+		}
+		try {
+			job.symbols_ = interpreter.parse(context, job.input_);
+		}
+		catch (...) {
+			job.symbols_ = nullptr;
+		}
+		read_stats_.busy_seconds_ += seconds_since(start);
+
+		push(lines_, job, read_stats_);
+		++read_stats_.items_;
+	}
+	lines_.close();
+}
+
+// Stage 2: turn the parse trees into expression trees and free them.
+// The tree is moved on to the evaluator, this thread keeps no handle to
+// it.  A line that cannot be built goes on with a null tree, so only it
+// fails.
+void
+Pipeline::build(void)
+{
+	Phase_Tracer::name_thread("build");
+
+	Job job;
+	while (pop(lines_, job, build_stats_)) {
+		Clock::time_point start = Clock::now();
+		try {
+			job.tree_ = Interpreter::build(job.symbols_);
+		}
+		catch (...) {
+			job.tree_ = TREE();
+		}
+		Interpreter::release(job.symbols_);
+		job.symbols_ = nullptr;
+		build_stats_.busy_seconds_ += seconds_since(start);
+
+		push(trees_, job, build_stats_);
+		++build_stats_.items_;
+	}
+	trees_.close();
+}
+
+// Stage 3: evaluate the trees and write the results.  A null tree, or
+// one that cannot be evaluated, e.g. because it divides by 0, is
+// written as "<input> = ?".
+void
+Pipeline::evaluate(std::ostream &output)
+{
+	Phase_Tracer::name_thread("evaluate");
+
+	Job job;
+	while (pop(trees_, job, evaluate_stats_)) {
+		Clock::time_point start = Clock::now();
+		{
+			Trace_Span span("evaluate");
+			Latency_Span latency(EVALUATE_LATENCY);
+			bool evaluated = false;
+			int result = 0;
+			if (!job.tree_.is_null()) {
+				try {
+					result = job.tree_.evaluate();
+					evaluated = true;
+				}
+				catch (...) {
+				}
+			}
+			if (evaluated)
+				output << job.input_ << " = " << result << std::endl;
+			else
+				output << job.input_ << " = ?" << std::endl;
+		}
+
+		// Release the tree here rather than when the slot is reused.
+		{
+			Trace_Span release_span("release");
+			job.tree_ = TREE();
+		}
+		evaluate_stats_.busy_seconds_ += seconds_since(start);
+		++evaluate_stats_.items_;
+
+		// Print the latency percentiles so far if they were asked for,
+		// away from the results.
+		Latency_Histograms::poll(std::cerr);
+	}
+}
+
+// Move <job> into <ring>, waiting while the ring is full.
+void
+Pipeline::push(SPSC_Ring<Job> &ring, Job &job, Stage_Stats &stats)
+{
+	while (!ring.try_push(std::move(job))) {
+		++stats.output_waits_;
+		std::this_thread::yield();
+	}
+}
+
+// Take the next job from <ring>, waiting while the ring is empty.
+bool
+Pipeline::pop(SPSC_Ring<Job> &ring, Job &job, Stage_Stats &stats)
+{
+	for (;;) {
+		if (ring.try_pop(job)) {
+			stats.occupancy_sum_ += ring.size() + 1;
+			return true;
+		}
+		if (ring.is_done())
+			return false;
+		++stats.input_waits_;
+		std::this_thread::yield();
+	}
+}
+
+// Print the per stage metrics of the last run.
+void
+Pipeline::print_stats(std::ostream &output) const
+{
+	const char *names[] = { "read", "build", "evaluate" };
+	const Stage_Stats *stats[] = { &read_stats_, &build_stats_, &evaluate_stats_ };
+	const SPSC_Ring<Job> *inputs[] = { nullptr, &lines_, &trees_ };
+
+	output << "stage, items, busy %, input waits, output waits, input ring occupancy %" << std::endl;
+	for (size_t i = 0; i < 3; ++i) {
+		const Stage_Stats &s = *stats[i];
+		double busy = elapsed_seconds_ > 0 ? 100 * s.busy_seconds_ / elapsed_seconds_ : 0;
+		double occupancy = inputs[i] != nullptr && s.items_ > 0
+			? 100 * s.occupancy_sum_ / s.items_ / inputs[i]->capacity()
+			: 0;
+		output << names[i] << ", " << s.items_
+			<< std::fixed << std::setprecision(1)
+			<< ", " << busy
+			<< ", " << s.input_waits_
+			<< ", " << s.output_waits_
+			<< ", " << occupancy << std::endl;
+	}
+	output << "elapsed seconds, " << std::setprecision(6) << elapsed_seconds_ << std::endl;
+}
+
+#endif /* _Pipeline_CPP */
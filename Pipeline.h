@@ -0,0 +1,112 @@
+#pragma once
+#ifndef _Pipeline_H
+#define _Pipeline_H
+
+// This header defines "size_t"
+#include <stdlib.h>
+#include <string>
+#include <iostream>
+
+#include "Tree.h"
+#include "SPSC_Ring.h"
+
+// Forward declaration.
+class Symbol;
+
+/**
+* @class Pipeline
+* @brief Evaluates a stream of expressions, one per line, with the
+*        reading and parsing, building and evaluating stages each
+*        running on its own thread.
+*
+*        The stages are connected by SPSC_Rings.  While one expression
+*        is evaluated the next ones are already being built and parsed,
+*        so the sustained rate is set by the slowest stage instead of
+*        the sum of the three.  When a ring fills up its producer waits
+*        (backpressure), so memory use is bounded by the ring sizes.
+*/
+class Pipeline
+{
+public:
+	/// Ctor - <ring_size> is the capacity of each ring between stages.
+	Pipeline(size_t ring_size = 1024);
+
+	/// Dtor
+	~Pipeline(void);
+
+	/// Evaluate every non blank line of <input> and write the results to
+	/// <output> in input order.  Returns the number of expressions.  A
+	/// Pipeline can only be run once.
+	size_t run(std::istream &input, std::ostream &output);
+
+	/// Print the per stage metrics of the last run.
+	void print_stats(std::ostream &output) const;
+
+private:
+	/// One expression as it travels through the stages.
+	struct Job
+	{
+		Job(void)
+			:symbols_{ nullptr }
+		{}
+
+		std::string input_;
+
+		/// Parse tree of <input_>, from the reader to the builder.
+		Symbol *symbols_;
+
+		TREE tree_;
+	};
+
+	/// What a stage did during the run.
+	struct Stage_Stats
+	{
+		Stage_Stats(void);
+
+		/// Items the stage has finished.
+		size_t items_;
+
+		/// Times the stage found its input ring empty.
+		size_t input_waits_;
+
+		/// Times the stage found its output ring full.
+		size_t output_waits_;
+
+		/// Time spent doing the stage's own work.
+		double busy_seconds_;
+
+		/// Sum of the input ring occupancy seen at each pop.
+		double occupancy_sum_;
+	};
+
+	/// Stage 1: read, trim and parse lines.
+	void read(std::istream &input);
+
+	/// Stage 2: turn the parse trees into expression trees.
+	void build(void);
+
+	/// Stage 3: evaluate the trees and write the results.
+	void evaluate(std::ostream &output);
+
+	/// Move <job> into <ring>, waiting while the ring is full.
+	void push(SPSC_Ring<Job> &ring, Job &job, Stage_Stats &stats);
+
+	/// Take the next job from <ring>, waiting while the ring is empty.
+	/// Returns false once the ring is closed and drained.
+	bool pop(SPSC_Ring<Job> &ring, Job &job, Stage_Stats &stats);
+
+	/// Lines parsed, waiting to be built.
+	SPSC_Ring<Job> lines_;
+
+	/// Trees built, waiting to be evaluated.
+	SPSC_Ring<Job> trees_;
+
+	Stage_Stats read_stats_;
+	Stage_Stats build_stats_;
+	Stage_Stats evaluate_stats_;
+
+	/// Wall clock time of the last run.
+	double elapsed_seconds_;
+};
+
+#endif /* _Pipeline_H */
@@ -0,0 +1,125 @@
+#include "stdafx.h"
+
+#if !defined (_Pruning_Visitor_CPP)
+#define _Pruning_Visitor_CPP
+
+#include "Component_Node.h"
+#include "Leaf_Node.h"
+#include "Composite_Negate_Node.h"
+#include "Composite_Add_Node.h"
+#include "Composite_Subtract_Node.h"
+#include "Composite_Divide_Node.h"
+#include "Composite_Multiply_Node.h"
+
+#include "Pruning_Visitor.h"
+
+// Ctor
+Pruning_Visitor::Pruning_Visitor(void)
+	:control_{ CONTINUE_TRAVERSAL }
+{}
+
+/// visit method for Leaf_Node<int> instance
+void Pruning_Visitor::visit(const LEAF_NODE&)
+{}
+
+/// visit method for Composite_Negate_Node<int> instance
+void Pruning_Visitor::visit(const COMPOSITE_NEGATE_NODE&)
+{}
+
+/// visit method for Composite_Add_Node<int> instance
+void Pruning_Visitor::visit(const COMPOSITE_ADD_NODE&)
+{}
+
+/// visit method for Composite_Subtract_Node<int> instance
+void Pruning_Visitor::visit(const COMPOSITE_SUBTRACT_NODE&)
+{}
+
+/// visit method for Composite_Multiply_Node<int> instance
+void Pruning_Visitor::visit(const COMPOSITE_MULTIPLY_NODE&)
+{}
+
+/// visit method for Composite_Divide_Node<int> instance
+void Pruning_Visitor::visit(const COMPOSITE_DIVIDE_NODE&)
+{}
+
+// Ctor
+Find_Division_By_Zero::Find_Division_By_Zero(void)
+	:found_{ nullptr }
+{}
+
+// A divisor is the literal 0 if it is a leaf holding 0, a leaf being
+// the only node without children.
+void Find_Division_By_Zero::visit(const COMPOSITE_DIVIDE_NODE& node)
+{
+	const Component_Node<int> *divisor = node.right();
+	if (divisor->left() == nullptr && divisor->right() == nullptr && divisor->item() == 0) {
+		found_ = &node;
+		stop();
+	}
+}
+
+// Ctor
+Find_Leaf::Find_Leaf(int item)
+	:item_{ item }, found_{ nullptr }
+{}
+
+// Stop at the first leaf holding <item_>.
+void Find_Leaf::visit(const LEAF_NODE& node)
+{
+	if (node.item() == item_) {
+		found_ = &node;
+		stop();
+	}
+}
+
+// Ctor
+Find_Variable::Find_Variable(int variable)
+	:variable_{ variable }, found_{ nullptr }
+{}
+
+// Stop at the first leaf of <variable_>.
+void Find_Variable::visit(const LEAF_NODE& node)
+{
+	if (node.variable() == variable_) {
+		found_ = &node;
+		stop();
+	}
+}
+
+// Ctor
+Count_Terms::Count_Terms(void)
+	:terms_{ 0 }
+{}
+
+/// visit method for Leaf_Node<int> instance
+void Count_Terms::visit(const LEAF_NODE&)
+{
+	term();
+}
+
+/// visit method for Composite_Negate_Node<int> instance
+void Count_Terms::visit(const COMPOSITE_NEGATE_NODE&)
+{
+	term();
+}
+
+/// visit method for Composite_Multiply_Node<int> instance
+void Count_Terms::visit(const COMPOSITE_MULTIPLY_NODE&)
+{
+	term();
+}
+
+/// visit method for Composite_Divide_Node<int> instance
+void Count_Terms::visit(const COMPOSITE_DIVIDE_NODE&)
+{
+	term();
+}
+
+// Count a term, leaving out the nodes under it.
+void Count_Terms::term(void)
+{
+	++terms_;
+	skip_children();
+}
+
+#endif /* _Pruning_Visitor_CPP */
@@ -0,0 +1,239 @@
+#pragma once
+#ifndef _Pruning_Visitor_H
+#define _Pruning_Visitor_H
+
+#include "Visitor.h"
+#include "Typedefs.h"
+#include "Tree.h"
+
+/// What a Pruning_Visitor asks of the traversal after a visit.
+enum Traversal_Control
+{
+	/// Go on to the next node.
+	CONTINUE_TRAVERSAL,
+
+	/// Leave out the nodes under the one just visited.
+	SKIP_CHILDREN,
+
+	/// Visit no more nodes.
+	STOP_TRAVERSAL
+};
+
+/**
+* @class Pruning_Visitor is a subclass of Visitor
+* @brief A Visitor that tells traverse_pruned, after each visit, to go
+*        on, to leave out the children of the node or to stop, so a
+*        query only walks the part of the tree it needs.
+*
+*        The visit methods do nothing and go on; a query overrides the
+*        ones for the nodes it is about.
+*/
+class Pruning_Visitor : public Visitor
+{
+public:
+	/// Ctor
+	Pruning_Visitor(void);
+
+	/// Dtor
+	virtual ~Pruning_Visitor(void) {}
+
+	/// Visit method for LEAF_NODE instances
+	virtual void visit(const LEAF_NODE& node);
+
+	/// Visit method for COMPOSITE_NEGATE_NODE instances
+	virtual void visit(const COMPOSITE_NEGATE_NODE& node);
+
+	/// Visit method for COMPOSITE_ADD_NODE instances
+	virtual void visit(const COMPOSITE_ADD_NODE& node);
+
+	/// Visit method for COMPOSITE_SUBTRACT_NODE instances
+	virtual void visit(const COMPOSITE_SUBTRACT_NODE& node);
+
+	/// Visit method for COMPOSITE_MULTIPLY_NODE instances
+	virtual void visit(const COMPOSITE_MULTIPLY_NODE& node);
+
+	/// Visit method for COMPOSITE_DIVIDE_NODE instances
+	virtual void visit(const COMPOSITE_DIVIDE_NODE& node);
+
+	/// Returns what the last visit asked for, and goes back to
+	/// CONTINUE_TRAVERSAL for the next one.
+	Traversal_Control take_control(void) {
+		const Traversal_Control control = control_;
+		if (control != STOP_TRAVERSAL)
+			control_ = CONTINUE_TRAVERSAL;
+		return control;
+	}
+
+protected:
+	/// Ask for the children of the node being visited to be left out.
+	void skip_children(void) {
+		if (control_ != STOP_TRAVERSAL)
+			control_ = SKIP_CHILDREN;
+	}
+
+	/// Ask for the traversal to stop after this visit.
+	void stop(void) {
+		control_ = STOP_TRAVERSAL;
+	}
+
+private:
+	/// What the current visit asked for.
+	Traversal_Control control_;
+};
+
+/**
+* @class Find_Division_By_Zero is a subclass of Pruning_Visitor
+* @brief Finds the first division whose divisor is the literal 0 and
+*        stops there.  A divisor that only evaluates to 0, e.g. in
+*        5/(2-2) or 5/-0, is not found; evaluating such a tree throws
+*        the eval visitor's Division_By_Zero instead.
+*/
+class Find_Division_By_Zero : public Pruning_Visitor
+{
+public:
+	/// Ctor
+	Find_Division_By_Zero(void);
+
+	using Pruning_Visitor::visit;
+
+	/// Visit method for COMPOSITE_DIVIDE_NODE instances
+	virtual void visit(const COMPOSITE_DIVIDE_NODE& node);
+
+	/// Returns the division found, nullptr if there is none.
+	const COMPOSITE_DIVIDE_NODE *found(void) const {
+		return found_;
+	}
+
+private:
+	/// The first division by 0.
+	const COMPOSITE_DIVIDE_NODE *found_;
+};
+
+/**
+* @class Find_Leaf is a subclass of Pruning_Visitor
+* @brief Finds the first leaf holding <item>, a number or the value of
+*        a variable, and stops there.  Use Find_Variable to ask whether
+*        an expression uses a variable.
+*/
+class Find_Leaf : public Pruning_Visitor
+{
+public:
+	/// Ctor
+	explicit Find_Leaf(int item);
+
+	using Pruning_Visitor::visit;
+
+	/// Visit method for LEAF_NODE instances
+	virtual void visit(const LEAF_NODE& node);
+
+	/// Returns the leaf found, nullptr if there is none.
+	const LEAF_NODE *found(void) const {
+		return found_;
+	}
+
+private:
+	/// Item looked for.
+	int item_;
+
+	/// The first leaf holding <item_>.
+	const LEAF_NODE *found_;
+};
+
+/**
+* @class Find_Variable is a subclass of Pruning_Visitor
+* @brief Finds the first leaf built for the variable with id <variable>,
+*        see Interpreter_Context::variable_id, and stops there, e.g.
+*
+*        Find_Variable find(context.variable_id("x"));
+*        bool uses_x = traverse_pruned<Preorder>(tree, find);
+*/
+class Find_Variable : public Pruning_Visitor
+{
+public:
+	/// Ctor
+	explicit Find_Variable(int variable);
+
+	using Pruning_Visitor::visit;
+
+	/// Visit method for LEAF_NODE instances
+	virtual void visit(const LEAF_NODE& node);
+
+	/// Returns the leaf found, nullptr if there is none.
+	const LEAF_NODE *found(void) const {
+		return found_;
+	}
+
+private:
+	/// Id of the variable looked for.
+	int variable_;
+
+	/// The first leaf of <variable_>.
+	const LEAF_NODE *found_;
+};
+
+/**
+* @class Count_Terms is a subclass of Pruning_Visitor
+* @brief Counts the terms of the sum at the top of an expression, e.g.
+*        3 in 2*x+y-(4/z).  The additions and subtractions at the top
+*        are walked through; any other node is a term, and the nodes
+*        under it are left out.
+*/
+class Count_Terms : public Pruning_Visitor
+{
+public:
+	/// Ctor
+	Count_Terms(void);
+
+	using Pruning_Visitor::visit;
+
+	/// Visit method for LEAF_NODE instances
+	virtual void visit(const LEAF_NODE& node);
+
+	/// Visit method for COMPOSITE_NEGATE_NODE instances
+	virtual void visit(const COMPOSITE_NEGATE_NODE& node);
+
+	/// Visit method for COMPOSITE_MULTIPLY_NODE instances
+	virtual void visit(const COMPOSITE_MULTIPLY_NODE& node);
+
+	/// Visit method for COMPOSITE_DIVIDE_NODE instances
+	virtual void visit(const COMPOSITE_DIVIDE_NODE& node);
+
+	/// Returns the number of terms found.
+	size_t terms(void) const {
+		return terms_;
+	}
+
+private:
+	/// Count a term, leaving out the nodes under it.
+	void term(void);
+
+	/// Terms found so far.
+	size_t terms_;
+};
+
+/// Walk <tree> in <ORDER>, Preorder or Levelorder, handing each node to
+/// <visitor> and going on, leaving out the node's children or stopping
+/// as it asks.  The other orders reach a node's children before the
+/// node, so they cannot leave them out.  Returns true if the visitor
+/// stopped the walk, e.g. traverse_pruned<Preorder>(tree, find).
+template <typename ORDER, typename T>
+bool traverse_pruned(const Tree<T> &tree, Pruning_Visitor &visitor)
+{
+	Tree_Order_Iterator<T, ORDER> it = tree.template begin<ORDER>();
+	const Tree_Order_Iterator<T, ORDER> end = tree.template end<ORDER>();
+	while (it != end) {
+		it.get_node()->accept(visitor);
+		switch (visitor.take_control()) {
+		case SKIP_CHILDREN:
+			it.skip_subtree();
+			break;
+		case STOP_TRAVERSAL:
+			return true;
+		default:
+			++it;
+		}
+	}
+	return false;
+}
+
+#endif /* _Pruning_Visitor_H */
@@ -17,6 +17,36 @@ template <typename T>
 Queue<T>::~Queue(void)
 {}
 
+// Place the <n> items starting at <items> at the tail of the queue.
+template <typename T>
+void Queue<T>::enqueue_n(const T *items, size_t n)
+{
+	for (size_t i = 0; i < n; ++i)
+		enqueue(items[i]);
+}
+
+// Remove up to <n> items from the front of the queue into <items>.
+template <typename T>
+size_t Queue<T>::dequeue_n(T *items, size_t n)
+{
+	size_t count = 0;
+	for (; count < n && !is_empty(); ++count) {
+		items[count] = front();
+		dequeue();
+	}
+	return count;
+}
+
+// Remove all the items and append them to <items>.
+template <typename T>
+size_t Queue<T>::drain(std::vector<T> &items)
+{
+	size_t count = size();
+	size_t first = items.size();
+	items.resize(first + count);
+	return dequeue_n(items.data() + first, count);
+}
+
 // Copy constructor.
 template <typename T, typename QUEUE>
 Queue_Adapter<T, QUEUE>::Queue_Adapter(const Queue_Adapter<T, QUEUE> &rhs)
@@ -63,6 +93,7 @@ void Queue_Adapter<T, QUEUE>::enqueue(const T &new_item)
 {
 	try{
 		Q_.enqueue(new_item);
+		HOT_COUNT(QUEUE_ENQUEUES);
 	}
 	catch (typename QUEUE::Overflow &) { //Catch the Actual Q (eg LQueue) class exception
 		throw typename Queue<T>::Overflow(); //rethrow Queue class exception
@@ -76,6 +107,7 @@ void Queue_Adapter<T, QUEUE>::dequeue(void)
 {
 	try {
 		Q_.dequeue();
+		HOT_COUNT(QUEUE_DEQUEUES);
 	}
 	catch (typename QUEUE::Underflow &) { //Catch the Actual Q (eg LQueue) class exception
 		throw typename Queue<T>::Underflow(); //rethrow Queue class exception
@@ -122,4 +154,38 @@ Queue_Adapter<T, QUEUE>* Queue_Adapter<T, QUEUE>::clone(void)
 {
 	return new Queue_Adapter<T, QUEUE>(*this);
 }
+
+// Place the <n> items starting at <items> at the tail of the queue.
+template <typename T, typename QUEUE>
+void Queue_Adapter<T, QUEUE>::enqueue_n(const T *items, size_t n)
+{
+	try {
+		Q_.enqueue_n(items, n);
+		HOT_COUNT_N(QUEUE_ENQUEUES, n);
+	}
+	catch (typename QUEUE::Overflow &) { //Catch the Actual Q (eg LQueue) class exception
+		throw typename Queue<T>::Overflow(); //rethrow Queue class exception
+	}
+}
+
+// Remove up to <n> items from the front into <items>.
+template <typename T, typename QUEUE>
+size_t Queue_Adapter<T, QUEUE>::dequeue_n(T *items, size_t n)
+{
+	size_t count = Q_.dequeue_n(items, n);
+	HOT_COUNT_N(QUEUE_DEQUEUES, count);
+	return count;
+}
+
+// Remove all the items and append them to <items>.
+template <typename T, typename QUEUE>
+size_t Queue_Adapter<T, QUEUE>::drain(std::vector<T> &items)
+{
+	size_t count = Q_.size();
+	size_t first = items.size();
+	items.resize(first + count);
+	count = Q_.dequeue_n(items.data() + first, count);
+	HOT_COUNT_N(QUEUE_DEQUEUES, count);
+	return count;
+}
 #endif //_Queue_CPP
\ No newline at end of file
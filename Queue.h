@@ -6,6 +6,9 @@
 #include <stdlib.h>
 
 #include <stdexcept>
+#include <vector>
+
+#include "Hot_Counters.h"
 
 /**
 * @class Queue
@@ -54,6 +57,24 @@ public:
 	// Clone the Queue.
 	virtual Queue<T> *clone(void) = 0;
 
+	// = Bulk operations.  These do the work of many of the calls above
+	// in one virtual call.  The defaults loop over the single item
+	// operations; subclasses override them where they can do better.
+
+	// Place the <n> items starting at <items> at the tail of the queue,
+	// in order.  Throws the <Overflow> exception if the queue fills up,
+	// the items before the one that did not fit stay enqueued.
+	virtual void enqueue_n(const T *items, size_t n);
+
+	// Remove up to <n> items from the front of the queue and store them
+	// in order starting at <items>.  Returns the number removed, which
+	// is 0 if the queue is empty.
+	virtual size_t dequeue_n(T *items, size_t n);
+
+	// Remove all the items and append them to <items>.  Returns the
+	// number removed.
+	virtual size_t drain(std::vector<T> &items);
+
 };
 
 /**
@@ -111,6 +132,17 @@ public:
 	/// Clone the Queue.
 	virtual Queue_Adapter<T, QUEUE> *clone(void);
 
+	/// = Bulk operations, delegated in one call to the QUEUE.
+
+	/// Place the <n> items starting at <items> at the tail of the queue.
+	virtual void enqueue_n(const T *items, size_t n);
+
+	/// Remove up to <n> items from the front into <items>.
+	virtual size_t dequeue_n(T *items, size_t n);
+
+	/// Remove all the items and append them to <items>.
+	virtual size_t drain(std::vector<T> &items);
+
 private:
 	/// The queue implementation that does all the real work.
 	QUEUE Q_;
@@ -2,6 +2,22 @@
 #ifndef _REFCOUNTER_H_
 #define _REFCOUNTER_H_
 
+#include "Hot_Counters.h"
+
+/**
+* @class Refcounter_Traits
+* @brief Says how a Refcounter disposes of an object whose count has
+*        dropped to 0.  Specialize it to dispose of a type differently.
+*/
+template <class T>
+struct Refcounter_Traits
+{
+	static void dispose(T *ptr)
+	{
+		delete ptr;
+	}
+};
+
 /**
 * @class Refcounter
 * @brief This class does reference counting in its constructor and
@@ -37,6 +53,15 @@ public:
 		increment();
 	}
 
+	/// move Ctor - takes over the reference held by <rhs> without
+	/// touching the count, so a handle can be passed to another thread
+	/// without the two threads updating the count concurrently.
+	Refcounter(Refcounter&& rhs)
+		: ptr_(rhs.ptr_)
+	{
+		rhs.ptr_ = nullptr;
+	}
+
 	/// Dtor will delete pointer if refcount becomes 0
 	~Refcounter(void)
 	{
@@ -62,6 +87,17 @@ public:
 		}
 	}
 
+	/// move assignment operator
+	void operator= (Refcounter&& rhs)
+	{
+		if (this != &rhs)
+		{
+			decrement();
+			ptr_ = rhs.ptr_;
+			rhs.ptr_ = nullptr;
+		}
+	}
+
 	/// dereference operator
 	T* operator-> (void) const
 	{
@@ -90,8 +126,10 @@ private:
 	/// implementation of the increment operation
 	void increment(void)
 	{
-		if (ptr_ != nullptr)
+		if (ptr_ != nullptr) {
+			HOT_COUNT(REFCOUNT_INCREMENTS);
 			ptr_->use_++;
+		}
 	}
 
 	/// implementation of the decrement operation
@@ -99,9 +137,10 @@ private:
 	{
 		if (ptr_ != nullptr)
 		{
+			HOT_COUNT(REFCOUNT_DECREMENTS);
 			ptr_->use_--;
 			if (ptr_->use_ == 0) {
-				delete ptr_;
+				Refcounter_Traits<T>::dispose(ptr_);
 				ptr_ = nullptr;
 			}
 
@@ -0,0 +1,80 @@
+#include "stdafx.h"
+#if !defined (_SPSC_RING_CPP)
+#define _SPSC_RING_CPP
+
+#include <utility>
+#include "SPSC_Ring.h"
+
+// Constructor.
+template <typename T>
+SPSC_Ring<T>::SPSC_Ring(size_t size)
+	:items_{ nullptr }, mask_{ 0 }, head_{ 0 }, tail_{ 0 }, closed_{ false }
+{
+	size_t capacity = 2;
+	while (capacity < size)
+		capacity <<= 1;
+
+	items_ = new T[capacity];
+	mask_ = capacity - 1;
+}
+
+// Dtor.
+template <typename T>
+SPSC_Ring<T>::~SPSC_Ring(void)
+{
+	delete[] items_;
+}
+
+// Move <new_item> into the ring.
+template <typename T>
+bool SPSC_Ring<T>::try_push(T &&new_item)
+{
+	const size_t tail = tail_.load(std::memory_order_relaxed);
+	if (tail - head_.load(std::memory_order_acquire) > mask_)
+		return false;
+
+	items_[tail & mask_] = std::move(new_item);
+	// Publish the item to the consumer.
+	tail_.store(tail + 1, std::memory_order_release);
+	return true;
+}
+
+// No more items will be pushed.
+template <typename T>
+void SPSC_Ring<T>::close(void)
+{
+	closed_.store(true, std::memory_order_release);
+}
+
+// Move the oldest item into <item>.
+template <typename T>
+bool SPSC_Ring<T>::try_pop(T &item)
+{
+	const size_t head = head_.load(std::memory_order_relaxed);
+	if (head == tail_.load(std::memory_order_acquire))
+		return false;
+
+	item = std::move(items_[head & mask_]);
+	// Hand the slot back to the producer.
+	head_.store(head + 1, std::memory_order_release);
+	return true;
+}
+
+// Returns true once the ring is closed and empty.  <closed_> is read
+// first: a push that happened before the close is then visible.
+template <typename T>
+bool SPSC_Ring<T>::is_done(void) const
+{
+	return closed_.load(std::memory_order_acquire)
+		&& head_.load(std::memory_order_relaxed) == tail_.load(std::memory_order_acquire);
+}
+
+// Returns the number of items in the ring.
+template <typename T>
+size_t SPSC_Ring<T>::size(void) const
+{
+	const size_t head = head_.load(std::memory_order_acquire);
+	return tail_.load(std::memory_order_acquire) - head;
+}
+
+#endif /* _SPSC_RING_CPP */
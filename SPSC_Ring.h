@@ -0,0 +1,88 @@
+#pragma once
+#if !defined (_SPSC_RING_H)
+#define _SPSC_RING_H
+
+// This header defines "size_t"
+#include <stdlib.h>
+
+#include <atomic>
+
+/**
+* @class SPSC_Ring
+* @brief Defines a bounded ring buffer connecting exactly one producer
+* thread to exactly one consumer thread.
+*
+* Only the producer writes <tail_> and only the consumer writes
+* <head_>, so both <try_push> and <try_pop> finish in a fixed number
+* of steps without compare-and-swap (they are wait-free).  A full ring
+* makes <try_push> fail, which is how a slow consumer pushes back on
+* its producer.  The producer calls <close> after its last item so the
+* consumer can tell an empty ring from a finished stream.
+*/
+template <typename T>
+class SPSC_Ring
+{
+public:
+	// Constructor.  <size> is rounded up to a power of two.
+	SPSC_Ring(size_t size);
+
+	// Dtor.
+	~SPSC_Ring(void);
+
+	// Producer side: move <new_item> into the ring.  Returns false,
+	// leaving <new_item> untouched, if the ring is full.
+	bool try_push(T &&new_item);
+
+	// Producer side: no more items will be pushed.
+	void close(void);
+
+	// Consumer side: move the oldest item into <item>.  Returns false
+	// if the ring is empty.
+	bool try_pop(T &item);
+
+	// Consumer side: returns true once the ring is closed and empty.
+	bool is_done(void) const;
+
+	// Returns the number of items in the ring, a snapshot when called
+	// concurrently with the producer or the consumer.
+	size_t size(void) const;
+
+	// Returns the number of slots.
+	size_t capacity(void) const {
+		return mask_ + 1;
+	}
+
+private:
+	// Copying is not supported.
+	SPSC_Ring(const SPSC_Ring<T> &);
+	void operator= (const SPSC_Ring<T> &);
+
+	// Size of the padding that keeps the two positions on separate
+	// cache lines.
+	static const size_t CACHE_LINE = 64;
+
+	T *items_;
+	// The ring.
+
+	size_t mask_;
+	// Number of slots - 1.
+
+	char pad0_[CACHE_LINE];
+
+	std::atomic<size_t> head_;
+	// Next position to pop, written by the consumer only.
+
+	char pad1_[CACHE_LINE];
+
+	std::atomic<size_t> tail_;
+	// Next position to push, written by the producer only.
+
+	std::atomic<bool> closed_;
+	// Set by the producer after its last push.
+
+	char pad2_[CACHE_LINE];
+};
+
+#include "SPSC_Ring.cpp"
+
+#endif /* _SPSC_RING_H */
@@ -33,6 +33,7 @@ void STLQueue_Adapter<T, QUEUE>::enqueue(const T &new_item)
 {
 	try {
 		Q_.push(new_item);
+		HOT_COUNT(QUEUE_ENQUEUES);
 	}
 	catch (...) {
 		throw Overflow();
@@ -45,6 +46,7 @@ template <typename T, typename QUEUE>
 void STLQueue_Adapter<T, QUEUE>::dequeue(void)
 {
 	if (!Q_.empty()) {
+		HOT_COUNT(QUEUE_DEQUEUES);
 		return Q_.pop();
 	}
 	else {
@@ -65,6 +67,33 @@ T STLQueue_Adapter<T, QUEUE>::front(void) const
 	}
 }
 
+// Place the <n> items starting at <items> at the tail of the queue.
+template <typename T, typename QUEUE>
+void STLQueue_Adapter<T, QUEUE>::enqueue_n(const T *items, size_t n)
+{
+	try {
+		for (size_t i = 0; i < n; ++i)
+			Q_.push(items[i]);
+		HOT_COUNT_N(QUEUE_ENQUEUES, n);
+	}
+	catch (...) {
+		throw Overflow();
+	}
+}
+
+// Remove up to <n> items from the front into <items>.
+template <typename T, typename QUEUE>
+size_t STLQueue_Adapter<T, QUEUE>::dequeue_n(T *items, size_t n)
+{
+	size_t count = 0;
+	for (; count < n && !Q_.empty(); ++count) {
+		items[count] = Q_.front();
+		Q_.pop();
+	}
+	HOT_COUNT_N(QUEUE_DEQUEUES, count);
+	return count;
+}
+
 // = Check boundary conditions for Queue operations. 
 
 // Returns 1 if the queue is empty, otherwise returns 0. 
@@ -52,6 +52,16 @@ public:
 		return new STLQueue_Adapter<T, QUEUE>(*this);
 	}
 
+	// = Bulk operations, looping over the STL queue directly.
+
+	// Place the <n> items starting at <items> at the tail of the queue.
+	// Throws the <Overflow> exception if memory is exhausted.
+	void enqueue_n(const T *items, size_t n);
+
+	// Remove up to <n> items from the front into <items>.  Returns the
+	// number removed.
+	size_t dequeue_n(T *items, size_t n);
+
 private:
 	// Instance of an STL queue.
 	QUEUE Q_;
@@ -2,10 +2,12 @@
 #ifndef _Tree_H
 #define _Tree_H
 #include <string>
+#include <utility>
 
 #include "Component_Node.h"
 #include "Refcounter.h"
 #include "Typedefs.h"
+#include "Tree_Stats.h"
 
 
 //Forward Declaration
@@ -15,8 +17,41 @@ class Tree_Iterator;
 template <typename T>
 class Const_Tree_Iterator;
 
+template <typename T, typename ORDER>
+class Tree_Order_Iterator;
+
+template <typename T, typename ORDER>
+class Tree_Order_Range;
+
+struct Postorder;
+
+template <typename ORDER>
+struct Reverse;
+
+template <typename T>
+class Post_Order_Eval_Visitor;
+
 class Visitor;
 
+template <typename T>
+class Tree_Compactor;
+
+/// = Orders in which Tree::compact lays out the nodes of a tree.
+enum Tree_Layout
+{
+	/// Parent, then its left subtree, then its right subtree.
+	PREORDER_LAYOUT,
+
+	/// One level after the other, left to right.
+	LEVEL_ORDER_LAYOUT,
+
+	/// van Emde Boas: the top half of the levels, then each subtree
+	/// hanging below it, each laid out the same way recursively.  Any
+	/// root to leaf path then crosses few cache lines whatever their
+	/// size.
+	VAN_EMDE_BOAS_LAYOUT
+};
+
 /**
 * @class Tree
 * @brief Defines a bridge to the node implementation that
@@ -41,12 +76,24 @@ public:
 
 	// Copy ctor
 	Tree(const Tree &t)
-		:root_{ t.root_ }
+		:root_{ t.root_ }, stats_{ t.stats_ }
+	{}
+
+	// Move ctor - takes over the reference of <t>, leaving it null
+	Tree(Tree &&t)
+		:root_{ std::move(t.root_) }, stats_{ std::move(t.stats_) }
 	{}
 
 	/// Assignment operator
 	void operator= (const Tree &t) {
 		root_ = t.root_;
+		stats_ = t.stats_;
+	}
+
+	/// Move assignment operator
+	void operator= (Tree &&t) {
+		root_ = std::move(t.root_);
+		stats_ = std::move(t.stats_);
 	}
 
 	//Equality operator
@@ -61,8 +108,8 @@ public:
 	}
 
 	//Dtor
-	//Nothing to do much here refcounter takes care of deleting the root node
-	//And all the nodes under root are auto poninter so they get cleaned up fine.
+	//Nothing to do much here refcounter hands the root node to the
+	//Node_Reclaimer, which deletes the nodes under it without recursion.
 	~Tree(void)
 	{}
 
@@ -186,17 +233,97 @@ public:
 		}
 	}
 
+	// = Factory methods that pick the traversal order at compile time.
+	// These return concrete iterators by value, e.g.
+	//   std::for_each(tree.begin<Preorder>(), tree.end<Preorder>(), f);
+	// and avoid both the string compare and the heap allocated
+	// Tree_Iterator_Impl of the methods above.
+
+	// Get an iterator that points to the beginning of the Tree 
+	// in <ORDER> (Levelorder, Preorder, Postorder or Inorder)
+	template <typename ORDER>
+	Tree_Order_Iterator<T, ORDER> begin(void) const {
+		return Tree_Order_Iterator<T, ORDER>(*this);
+	}
+
+	// Get the end sentinel for <ORDER>, this holds no traversal state
+	template <typename ORDER>
+	Tree_Order_Iterator<T, ORDER> end(void) const {
+		return Tree_Order_Iterator<T, ORDER>();
+	}
+
+	// Get an iterator that points to the last node of the Tree in
+	// <ORDER> and goes back to the first, without copying the traversal
+	// (Preorder, Postorder or Inorder)
+	template <typename ORDER>
+	Tree_Order_Iterator<T, Reverse<ORDER> > rbegin(void) const {
+		return Tree_Order_Iterator<T, Reverse<ORDER> >(*this);
+	}
+
+	// Get the end sentinel of rbegin<ORDER>
+	template <typename ORDER>
+	Tree_Order_Iterator<T, Reverse<ORDER> > rend(void) const {
+		return Tree_Order_Iterator<T, Reverse<ORDER> >();
+	}
+
+	// Get a range for use in a range based for loop
+	template <typename ORDER>
+	Tree_Order_Range<T, ORDER> traverse(void) const {
+		return Tree_Order_Range<T, ORDER>(*this);
+	}
+
+	// Return a copy of this tree with its nodes next to each other in
+	// memory in <layout> order, see Tree_Compactor.  Assign it over a
+	// long lived tree that is traversed often.
+	Tree<T> compact(Tree_Layout layout = PREORDER_LAYOUT) const {
+		return Tree_Compactor<T>::compact(*this, layout);
+	}
+
 	//Accept method for the Visitor 
 	void accept(Visitor&v) {
 		root_->accept(v);
 	}
+
+	// Return the value of the expression, found in one post order walk
+	// with a Post_Order_Eval_Visitor.  Only the walk's and the
+	// visitor's stacks are kept, both as deep as the tree is high.  The
+	// tree must not be null.  Throws the visitor's Division_By_Zero if a
+	// divisor evaluates to 0.
+	T evaluate(void) const {
+		Post_Order_Eval_Visitor<T> eval_visitor(*this);
+		for (Tree_Order_Iterator<T, Postorder> it = begin<Postorder>(),
+			last = end<Postorder>(); it != last; ++it)
+			it.get_node()->accept(eval_visitor);
+		return eval_visitor.yield();
+	}
+
+	// Return the statistics of this tree, walking it the first time
+	// and keeping them for this handle and its later copies.  The
+	// builders call this, so their trees come with the stats.
+	const Tree_Stats &stats(void) const {
+		if (stats_.is_null())
+			stats_ = Refcounter<Tree_Stats>(new Tree_Stats(get_root()));
+		return *stats_;
+	}
+
+	// Return true if the statistics are already kept with this handle.
+	bool has_stats(void) const {
+		return !stats_.is_null();
+	}
 	
 private:
 	/// The underlying pointer to the implementation. These are
 	/// reference counted.
 	Refcounter <Component_Node<T> > root_;
+
+	/// Statistics of the tree, shared by the copies of the handle made
+	/// after stats was first called.
+	mutable Refcounter<Tree_Stats> stats_;
 };
 
 #include "Tree_Iterator.h"
+#include "Tree_Order_Iterator.h"
+#include "Tree_Compactor.h"
+#include "Eval_Visitor.h"
 
 #endif /* _Tree_H */
\ No newline at end of file
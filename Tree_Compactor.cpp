@@ -0,0 +1,186 @@
+#include "stdafx.h"
+#if !defined (_Tree_Compactor_CPP)
+#define _Tree_Compactor_CPP
+
+#include <utility>
+#include "Tree_Compactor.h"
+
+// Return a copy of <tree> laid out in <layout>.
+template <typename T>
+Tree<T>
+Tree_Compactor<T>::compact(const Tree<T> &tree, Tree_Layout layout)
+{
+	if (tree.is_null())
+		return Tree<T>();
+
+	std::vector<Component_Node<T> *> order;
+	layout_order(tree, layout, order);
+
+	// The copies built so far whose parent is not built yet.  Anything
+	// left in here or in <memory> is given back if this throws.
+	std::vector<void *> memory(order.size());
+	std::unordered_map<const Component_Node<T> *, Component_Node<T> *> copies;
+	Unwind unwind(order, memory, copies);
+	copies.reserve(order.size());
+
+	// Reserve the memory in layout order.
+	for (size_t i = 0; i < order.size(); ++i)
+		memory[i] = Component_Node<T>::operator new(order[i]->node_size());
+
+	// Build the copies children first.  Every layout puts a parent
+	// before its children, so that is the reverse of <order>.
+	Component_Node<T> *copy = nullptr;
+	for (size_t i = order.size(); i-- > 0;) {
+		const Component_Node<T> *node = order[i];
+		Component_Node<T> *children[] = { node->left(), node->right() };
+		Node_Child<T> copied[2];
+
+		for (size_t c = 0; c < 2; ++c) {
+			if (children[c] == nullptr)
+				continue;
+			if (is_leaf(children[c]))
+				copied[c] = Node_Child<T>::immediate(children[c]->item(),
+					static_cast<const Leaf_Node<T> *>(children[c])->variable());
+			else
+				copied[c] = copies.at(children[c]);
+		}
+
+		// Make the entry first, so once relocate has built the copy and
+		// taken over the children nothing else can throw.
+		Component_Node<T> *&entry = copies[node];
+		copy = node->relocate(memory[i], copied[0], copied[1]);
+		memory[i] = nullptr;
+		entry = copy;
+		for (size_t c = 0; c < 2; ++c)
+			if (children[c] != nullptr && !is_leaf(children[c]))
+				copies.erase(children[c]);
+	}
+
+	// <copy> is the copy of order[0], the root, now owned by the tree.
+	copies.clear();
+	return Tree<T>(copy);
+}
+
+// Append the nodes compact gives their own memory in <layout> order.
+template <typename T>
+void
+Tree_Compactor<T>::layout_order(const Tree<T> &tree, Tree_Layout layout,
+	std::vector<Component_Node<T> *> &order)
+{
+	Component_Node<T> *root = tree.get_root();
+	if (root == nullptr)
+		return;
+
+	if (is_leaf(root)) {
+		order.push_back(root);
+		return;
+	}
+
+	switch (layout) {
+	case PREORDER_LAYOUT:
+		preorder(root, order);
+		break;
+	case LEVEL_ORDER_LAYOUT:
+		level_order(root, order);
+		break;
+	case VAN_EMDE_BOAS_LAYOUT:
+		van_emde_boas(root, height(root), order);
+		break;
+	}
+}
+
+// Parent, then its left subtree, then its right subtree.
+template <typename T>
+void
+Tree_Compactor<T>::preorder(Component_Node<T> *root, std::vector<Component_Node<T> *> &order)
+{
+	Inline_Stack<Component_Node<T> *> stack;
+	stack.push(root);
+
+	while (!stack.empty()) {
+		Component_Node<T> *node = stack.top();
+		stack.pop();
+		order.push_back(node);
+
+		if (Component_Node<T> *right = placed(node->right()))
+			stack.push(right);
+		if (Component_Node<T> *left = placed(node->left()))
+			stack.push(left);
+	}
+}
+
+// One level after the other.  <order> doubles as the queue.
+template <typename T>
+void
+Tree_Compactor<T>::level_order(Component_Node<T> *root, std::vector<Component_Node<T> *> &order)
+{
+	size_t next = order.size();
+	order.push_back(root);
+
+	for (; next < order.size(); ++next) {
+		Component_Node<T> *node = order[next];
+		if (Component_Node<T> *left = placed(node->left()))
+			order.push_back(left);
+		if (Component_Node<T> *right = placed(node->right()))
+			order.push_back(right);
+	}
+}
+
+// Lay out the top half of the <levels> levels under <root>, then each
+// subtree rooted just below them.  Recursion halves <levels>, so its
+// depth is only log(height); the subtree roots are found level by
+// level without recursion.
+template <typename T>
+void
+Tree_Compactor<T>::van_emde_boas(Component_Node<T> *root, size_t levels,
+	std::vector<Component_Node<T> *> &order)
+{
+	if (levels == 1) {
+		order.push_back(root);
+		return;
+	}
+
+	const size_t top = levels / 2;
+	van_emde_boas(root, top, order);
+
+	std::vector<Component_Node<T> *> frontier(1, root);
+	std::vector<Component_Node<T> *> below;
+	for (size_t level = 0; level < top && !frontier.empty(); ++level) {
+		below.clear();
+		for (size_t i = 0; i < frontier.size(); ++i) {
+			if (Component_Node<T> *left = placed(frontier[i]->left()))
+				below.push_back(left);
+			if (Component_Node<T> *right = placed(frontier[i]->right()))
+				below.push_back(right);
+		}
+		frontier.swap(below);
+	}
+
+	for (size_t i = 0; i < frontier.size(); ++i)
+		van_emde_boas(frontier[i], levels - top, order);
+}
+
+// Returns the number of levels of placed nodes under <root>.
+template <typename T>
+size_t
+Tree_Compactor<T>::height(Component_Node<T> *root)
+{
+	size_t levels = 0;
+	std::vector<Component_Node<T> *> frontier(1, root);
+	std::vector<Component_Node<T> *> below;
+
+	while (!frontier.empty()) {
+		++levels;
+		below.clear();
+		for (size_t i = 0; i < frontier.size(); ++i) {
+			if (Component_Node<T> *left = placed(frontier[i]->left()))
+				below.push_back(left);
+			if (Component_Node<T> *right = placed(frontier[i]->right()))
+				below.push_back(right);
+		}
+		frontier.swap(below);
+	}
+	return levels;
+}
+
+#endif /* _Tree_Compactor_CPP */
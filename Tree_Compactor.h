@@ -0,0 +1,100 @@
+#pragma once
+#ifndef _Tree_Compactor_H
+#define _Tree_Compactor_H
+
+#include <vector>
+#include <unordered_map>
+
+#include "Tree.h"
+#include "Component_Node.h"
+#include "Leaf_Node.h"
+#include "Node_Child.h"
+#include "Inline_Stack.h"
+
+/**
+* @class Tree_Compactor
+* @brief Copies a tree into consecutive memory in a chosen layout.
+*
+*        A tree built by the Interpreter sits wherever its nodes were
+*        allocated, in build order.  The copy made here has its nodes
+*        allocated back to back in <Tree_Layout> order, so the
+*        Node_Allocator carves them out of consecutive slab space, and
+*        leaves are immediate leaves inside their parent (see
+*        Node_Child).  All the memory is reserved before any node is
+*        built, since a parent is laid out before its children but can
+*        only be built after them.  If compact throws, the memory and
+*        the copies are given back.
+*/
+template <typename T>
+class Tree_Compactor
+{
+public:
+	/// Return a copy of <tree> laid out in <layout>.  <tree> itself is
+	/// untouched, assign the result over it to free the old nodes.
+	static Tree<T> compact(const Tree<T> &tree, Tree_Layout layout);
+
+	/// Append the nodes of <tree> that compact gives their own memory
+	/// (the composites, or the root if it is a leaf) to <order> in
+	/// <layout> order.
+	static void layout_order(const Tree<T> &tree, Tree_Layout layout,
+		std::vector<Component_Node<T> *> &order);
+
+private:
+	/// Returns true for a node compact stores inside its parent.
+	static bool is_leaf(const Component_Node<T> *node) {
+		return dynamic_cast<const Leaf_Node<T> *>(node) != nullptr;
+	}
+
+	/// Returns <node> if compact gives it its own memory, else nullptr.
+	static Component_Node<T> *placed(Component_Node<T> *node) {
+		return node != nullptr && !is_leaf(node) ? node : nullptr;
+	}
+
+	static void preorder(Component_Node<T> *root, std::vector<Component_Node<T> *> &order);
+
+	static void level_order(Component_Node<T> *root, std::vector<Component_Node<T> *> &order);
+
+	/// Lay out the first <levels> levels of the subtree at <root>.
+	static void van_emde_boas(Component_Node<T> *root, size_t levels,
+		std::vector<Component_Node<T> *> &order);
+
+	/// Returns the number of levels of placed nodes under <root>.
+	static size_t height(Component_Node<T> *root);
+
+	/// What compact has reserved and built so far, given back if it
+	/// throws: the memory not yet built in, freed, and the copies not
+	/// yet taken over by a parent, released.
+	class Unwind
+	{
+	public:
+		/// Ctor
+		Unwind(const std::vector<Component_Node<T> *> &order,
+			std::vector<void *> &memory,
+			std::unordered_map<const Component_Node<T> *, Component_Node<T> *> &copies)
+			:order_(order), memory_(memory), copies_(copies)
+		{}
+
+		/// Dtor
+		~Unwind(void) {
+			for (size_t i = 0; i < memory_.size(); ++i)
+				if (memory_[i] != nullptr)
+					Component_Node<T>::operator delete(memory_[i], order_[i]->node_size());
+			for (typename std::unordered_map<const Component_Node<T> *, Component_Node<T> *>::iterator
+				it = copies_.begin(); it != copies_.end(); ++it)
+				Tree<T> release(it->second);
+		}
+
+	private:
+		// Copying is not supported.
+		Unwind(const Unwind &);
+		void operator= (const Unwind &);
+
+		const std::vector<Component_Node<T> *> &order_;
+		std::vector<void *> &memory_;
+		std::unordered_map<const Component_Node<T> *, Component_Node<T> *> &copies_;
+	};
+};
+
+#include "Tree_Compactor.cpp"
+
+#endif /* _Tree_Compactor_H */
@@ -4,6 +4,7 @@
 
 #include "Tree.h"
 #include "Tree_Iterator_Impl.h"
+#include "Tree_Iterator_Stream.h"
 #include "Refcounter.h"
 
 /**
@@ -11,6 +12,9 @@
 * @brief Defines a bridge to the Tree_Iterator_Impl that
 *        contains the implementation of the iterator.
 *
+*        The positions produced by the Tree_Iterator_Impl are kept in
+*        a Tree_Iterator_Stream that all copies share, so copying an
+*        iterator never clones the Tree_Iterator_Impl.
 */
 template <typename T>
 class Tree_Iterator
@@ -18,48 +22,44 @@ class Tree_Iterator
 public:
 	/// Construct a Tree_Iterator 
 	Tree_Iterator(Tree_Iterator_Impl<T>* impl)
-		:tree_iterator_impl_{ impl }
+		:stream_{ impl }
 	{}
 
-	/// Copy ctor - needed for reference counting.
+	/// Copy ctor - shares the traversal state, this is O(1).
 	Tree_Iterator(const Tree_Iterator<T> &tree_iterator)
-		:tree_iterator_impl_{tree_iterator.tree_iterator_impl_}
+		:stream_{tree_iterator.stream_}
 	{}
 
-	/// Assignment operator - needed for reference counting.
+	/// Assignment operator - shares the traversal state.
 	void operator= (const Tree_Iterator<T> &tree_iterator) {
 		if (this != &tree_iterator) {
-			tree_iterator_impl_ = tree_iterator.tree_iterator_impl_;
+			stream_ = tree_iterator.stream_;
 		}
 	}
 
-	/// Dereference operator returns a reference to the item contained
-	/// at the current position
-	Tree<T>& operator* (void) {
-		return (*(*tree_iterator_impl_));
-	}
-
-	/// Returns a const reference to the item contained at the current position
+	/// Dereference operator returns a const reference to the item
+	/// contained at the current position.  The item is shared with the
+	/// copies of this iterator, so it cannot be written through it.
 	const Tree<T>& operator* (void) const {
-		return (*(*tree_iterator_impl_));
+		return stream_.current();
 	}
 
 	/// Preincrement operator
 	Tree_Iterator<T> &operator++ (void) {
-		++(*tree_iterator_impl_);
+		stream_.advance();
 		return *this;
 	}
 
 	/// Postincrement operator
 	Tree_Iterator<T> operator++ (int) {
-		Tree_Iterator<T> temp(tree_iterator_impl_->clone());
-		++(*tree_iterator_impl_);
+		Tree_Iterator<T> temp(*this);
+		stream_.advance();
 		return temp;
 	}
 
 	/// Equality operator
 	bool operator== (const Tree_Iterator<T> &rhs) const {
-		return ((this == &rhs) || ((*tree_iterator_impl_) == *(rhs.tree_iterator_impl_)));
+		return ((this == &rhs) || (stream_ == rhs.stream_));
 	}
 
 	/// Nonequality operator
@@ -70,13 +70,14 @@ public:
 	// = Necessary traits
 	typedef std::forward_iterator_tag iterator_category;
 	typedef Tree<T> value_type;
-	typedef Tree<T> *pointer;
-	typedef Tree<T> &reference;
+	typedef const Tree<T> *pointer;
+	typedef const Tree<T> &reference;
 	typedef int difference_type;
 
 private:
-	/// reference counted Pointer to the tree_iterator_impln.
-	Refcounter <Tree_Iterator_Impl<T> > tree_iterator_impl_;
+	/// Position in the traversal produced by the tree_iterator_impl,
+	/// shared with the copies of this iterator until it is advanced.
+	Tree_Iterator_Stream<T> stream_;
 };
 /*
 /**
@@ -91,44 +92,44 @@ class Const_Tree_Iterator
 public:
 	/// Construct a Const_Tree_Iterator
 	Const_Tree_Iterator(Tree_Iterator_Impl<T>* impl)
-		:tree_iterator_impl_{impl}
+		:stream_{impl}
 	{}
 
-	/// Copy ctor - needed for reference counting.
+	/// Copy ctor - shares the traversal state, this is O(1).
 	Const_Tree_Iterator(const Const_Tree_Iterator<T> &tree_iterator)
-		:tree_iterator_impl_{tree_iterator.tree_iterator_impl_}
+		:stream_{tree_iterator.stream_}
 	{}
 
-	/// Assignment operator - needed for reference counting.
+	/// Assignment operator - shares the traversal state.
 	void operator= (const Const_Tree_Iterator<T> &tree_iterator) {
 		if (this != &tree_iterator) {
-			tree_iterator_impl_ = tree_iterator.tree_iterator_impl_;
+			stream_ = tree_iterator.stream_;
 		}
 	}
 
 
 	/// Returns a const reference to the item contained at the current position
 	const Tree<T>& operator* (void) const {
-		return (*(*tree_iterator_impl_));
+		return stream_.current();
 	}
 
 	/// Preincrement operator
 	Const_Tree_Iterator<T> &operator++ (void) {
-		++(*tree_iterator_impl_);
+		stream_.advance();
 		return (*this);
 	}
 
 	/// Postincrement operator
 	Const_Tree_Iterator<T> operator++ (int) {
-		Const_Tree_Iterator<T> temp(tree_iterator_impl_->clone());
-		++*tree_iterator_impl_;
+		Const_Tree_Iterator<T> temp(*this);
+		stream_.advance();
 		return temp;
 	}
 
 
 	/// Equality operator
 	bool operator== (const Const_Tree_Iterator<T> &rhs) const {
-		return ((this == &rhs) || ((*tree_iterator_impl_) == *(rhs.tree_iterator_impl_)));
+		return ((this == &rhs) || (stream_ == rhs.stream_));
 	}
 
 	/// Nonequality operator
@@ -139,13 +140,14 @@ public:
 	// = Necessary traits
 	typedef std::forward_iterator_tag iterator_category;
 	typedef Tree<T> value_type;
-	typedef Tree<T> *pointer;
-	typedef Tree<T> &reference;
+	typedef const Tree<T> *pointer;
+	typedef const Tree<T> &reference;
 	typedef int difference_type;
 
 private:
-	/// reference counted Pointer to the tree_iterator_impln.
-	Refcounter <Tree_Iterator_Impl<T> > tree_iterator_impl_;
+	/// Position in the traversal produced by the tree_iterator_impl,
+	/// shared with the copies of this iterator until it is advanced.
+	Tree_Iterator_Stream<T> stream_;
 
 };
 #endif /* _Tree_Iterator_H */
\ No newline at end of file
@@ -6,10 +6,12 @@
 #include "Queue.h"
 #include "LQueue.h"
 #include "STLQueue.h"
+#include "AQueue.h"
 #include "Typedefs.h"
 #include "Refcounter.h"
 #include "Options.h"
-#include <stack>
+#include "Inline_Stack.h"
+#include <vector>
 
 /**
 * @class Tree_Iterator_Impl
@@ -97,6 +99,12 @@ private:
 /**
 * @class Level_Order_Tree_Iterator_Impl
 * @brief Implementation of the Tree_Iterator based on Level_Order traversal.
+*
+*        The iterator walks a whole level (the frontier) held in a
+*        vector.  Only when it moves past the end of the level does it
+*        touch the queue strategy: the children of the level go in with
+*        one enqueue_n call and come out as the next level with one
+*        drain call.
 */
 
 template <typename T>
@@ -105,21 +113,28 @@ class Level_Order_Tree_Iterator_Impl :public Tree_Iterator_Impl<T>
 public:
 
 	/// Default ctor - needed for reference counting, for end
+	/// The end iterator never touches its queue so none is created.
 	Level_Order_Tree_Iterator_Impl()
-		:queue_(make_queue_strategy()), front_(nullptr, false)
+		:queue_(nullptr), frontier_(), pos_(0), front_(nullptr, false)
 	{}
 
-	/// Constructor that takes in an entry
+	/// Constructor that takes in an entry.  If the tree's Tree_Stats
+	/// are kept with it, the queue and the levels are sized for its
+	/// widest level up front.
 	Level_Order_Tree_Iterator_Impl(Tree<T> &tree)
-		:queue_(make_queue_strategy()),front_()
+		:queue_(make_queue_strategy(tree.has_stats() ? tree.stats().max_width_ : 0)),
+		frontier_(1, tree), children_(), pos_(0), front_(tree)
 	{
-		queue_->enqueue(tree);
-		front_ = queue_->front();
+		if (tree.has_stats()) {
+			frontier_.reserve(tree.stats().max_width_);
+			children_.reserve(tree.stats().max_width_);
+		}
 	}
 
 	//copy
 	Level_Order_Tree_Iterator_Impl(const Level_Order_Tree_Iterator_Impl<T>& rhs)
-		:queue_(rhs.queue_->clone()),front_(rhs.front_)
+		:queue_(rhs.queue_.get() != nullptr ? rhs.queue_->clone() : nullptr),
+		frontier_(rhs.frontier_), children_(), pos_(rhs.pos_), front_(rhs.front_)
 	{}
 
 	virtual ~Level_Order_Tree_Iterator_Impl(void)
@@ -141,17 +156,12 @@ public:
 
 	/// Preincrement operator
 	virtual Level_Order_Tree_Iterator_Impl<T>& operator++ (void) {
-		if (!queue_->is_empty()) {
-			queue_->dequeue();
-			
-			if (!front_.left().is_null())
-				queue_->enqueue(front_.left());
-
-			if (!front_.right().is_null())
-				queue_->enqueue(front_.right());
+		if (!front_.is_null()) {
+			if (++pos_ == frontier_.size())
+				next_level();
 
-			if (!queue_->is_empty())
-				front_ = queue_->front();
+			if (pos_ < frontier_.size())
+				front_ = frontier_[pos_];
 			else
 				front_ = Tree<T>(nullptr, false);
 		}
@@ -174,20 +184,53 @@ public:
 
 private:
 	std::auto_ptr<QUEUE> queue_;
+
+	/// The level being visited, in order.
+	std::vector<Tree<T> > frontier_;
+
+	/// The next level as it is collected, kept to reuse its buffer.
+	std::vector<Tree<T> > children_;
+
+	/// Index of the current node in <frontier_>.
+	size_t pos_;
+
 	Tree<T> front_;
 	static const size_t AQUEUE_SIZE = 50;
-	QUEUE * make_queue_strategy()
+
+	/// Replace <frontier_> by the children of its nodes, passing them
+	/// through the queue strategy in bulk.
+	void next_level(void) {
+		children_.clear();
+		children_.reserve(2 * frontier_.size());
+		for (size_t i = 0; i < frontier_.size(); ++i) {
+			Component_Node<T> *node = frontier_[i].get_root();
+			if (node->left() != nullptr)
+				children_.push_back(Tree<T>(node->left(), true));
+			if (node->right() != nullptr)
+				children_.push_back(Tree<T>(node->right(), true));
+		}
+
+		queue_->enqueue_n(children_.data(), children_.size());
+		children_.clear();
+		frontier_.clear();
+		queue_->drain(frontier_);
+		pos_ = 0;
+	}
+
+	/// Make the queue strategy, sized for levels of <width> nodes.
+	QUEUE * make_queue_strategy(size_t width)
 	{
-		//Using the option class leads to a linker error which I am unable to fix so hard coding it
-		std::string queue_type = "STLQueue";// Options::instance()->queue_type();
+		// The queue strategy is chosen with the -q command line option.
+		const size_t size_hint = width > AQUEUE_SIZE ? width : AQUEUE_SIZE;
+		std::string queue_type = Options::instance()->queue_type();
 		if (queue_type.compare("LQueue") == 0) {
-			return new LQUEUE_ADAPTER(Level_Order_Tree_Iterator_Impl::AQUEUE_SIZE);
+			return new LQUEUE_ADAPTER(size_hint);
 		}
-		else if (queue_type.compare("AQueue") == 0) { //Don't have AQueue implemented
-			return new LQUEUE_ADAPTER(Level_Order_Tree_Iterator_Impl::AQUEUE_SIZE);
+		else if (queue_type.compare("AQueue") == 0) {
+			return new AQUEUE_ADAPTER(size_hint);
 		}
 		else if (queue_type.compare("STLQueue") == 0) {
-			return new STLQueue_Adapter<TREE>(Level_Order_Tree_Iterator_Impl::AQUEUE_SIZE);
+			return new STLQueue_Adapter<TREE>(size_hint);
 		}
 		else {
 			throw typename Unknown_Order(queue_type + " is unknown queue strategy");
@@ -215,6 +258,9 @@ public:
 	/// Constructor that takes in an entry
 	Pre_Order_Tree_Iterator_Impl(Tree<T> &tree)
 	{
+		// One pending right child per level, and the current node.
+		if (tree.has_stats())
+			stack_.reserve(tree.stats().height_ + 1);
 		stack_.push(tree);
 		current_ = stack_.top();
 	}
@@ -277,7 +323,7 @@ public:
 
 private:
 	Tree<T> current_;
-	std::stack<Tree<T>> stack_;
+	Inline_Stack<Tree<T>, 16> stack_;
 };
 
 /**
@@ -300,6 +346,9 @@ public:
 	/// Constructor that takes in an entry
 	Post_Order_Tree_Iterator_Impl(const Tree<T> &tree)
 	{
+		// The stack holds the ancestors of the current node.
+		if (tree.has_stats())
+			stack_.reserve(tree.stats().height_);
 		traverseDown(tree);
 		current_ = stack_.top();
 	}
@@ -367,7 +416,7 @@ public:
 
 private:
 	Tree<T> current_;
-	std::stack<Tree<T>> stack_;
+	Inline_Stack<Tree<T>, 16> stack_;
 	void traverseDown(Tree<T> tempTree) {
 		bool continueFlag = true;
 		while (!tempTree.is_null() && continueFlag) {
@@ -399,6 +448,9 @@ public:
 	/// Constructor that takes in an entry
 	In_Order_Tree_Iterator_Impl(const Tree<T> &tree)
 	{
+		// The stack holds the ancestors still to be visited.
+		if (tree.has_stats())
+			stack_.reserve(tree.stats().height_);
 		traverseDown(tree);
 		current_ = stack_.top();
 		stack_.pop();
@@ -461,7 +513,7 @@ public:
 
 private:
 	Tree<T> current_;
-	std::stack<Tree<T>> stack_;
+	Inline_Stack<Tree<T>, 16> stack_;
 	void traverseDown(Tree<T> tempTree) {
 		bool continueFlag = true;
 		while (!tempTree.is_null() && continueFlag) {
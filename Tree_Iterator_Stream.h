@@ -0,0 +1,139 @@
+#pragma once
+#ifndef _Tree_Iterator_Stream_H
+#define _Tree_Iterator_Stream_H
+
+// This header defines "size_t"
+#include <stdlib.h>
+
+#include "Tree.h"
+#include "Tree_Iterator_Impl.h"
+#include "Refcounter.h"
+
+/**
+* @class Tree_Iterator_Chunk
+* @brief A block of consecutive positions of a traversal.
+*
+*        Chunks form a singly linked list that is produced lazily from
+*        a Tree_Iterator_Impl and shared by every copy of a
+*        Tree_Iterator.  Once written a chunk is never modified, so
+*        copies can share it without copying it.  A chunk holds one
+*        reference on its successor and is freed as soon as no
+*        iterator and no predecessor refers to it.
+*/
+template <typename T>
+class Tree_Iterator_Chunk
+{
+	friend class Refcounter <Tree_Iterator_Chunk<T> >; // allows refcounting
+public:
+	/// Number of positions stored per chunk.
+	static const size_t CAPACITY = 32;
+
+	/// Ctor
+	Tree_Iterator_Chunk(void)
+		:count_{ 0 }, next_{ nullptr }, use_{ 1 }
+	{}
+
+	/// Dtor - releases the successors iteratively, so dropping the
+	/// front of a long chain does not recurse once per chunk.
+	~Tree_Iterator_Chunk(void) {
+		Tree_Iterator_Chunk<T> *next = next_;
+		while (next != nullptr && --next->use_ == 0) {
+			Tree_Iterator_Chunk<T> *after = next->next_;
+			next->next_ = nullptr;
+			delete next;
+			next = after;
+		}
+	}
+
+	/// Fill a new chunk with the next positions of <impl>.  Returns
+	/// nullptr if <impl> is already at the end.
+	static Tree_Iterator_Chunk<T> *make(Tree_Iterator_Impl<T> &impl) {
+		if ((*impl).is_null())
+			return nullptr;
+
+		Tree_Iterator_Chunk<T> *chunk = new Tree_Iterator_Chunk<T>();
+		while (chunk->count_ < CAPACITY && !(*impl).is_null()) {
+			chunk->items_[chunk->count_++] = *impl;
+			++impl;
+		}
+		return chunk;
+	}
+
+	/// Positions held by this chunk.
+	Tree<T> items_[CAPACITY];
+
+	/// Number of valid entries in <items_>.
+	size_t count_;
+
+	/// Next chunk, nullptr until some iterator has moved past this one.
+	Tree_Iterator_Chunk<T> *next_;
+
+private:
+	/// Reference counter
+	int use_;
+};
+
+/**
+* @class Tree_Iterator_Stream
+* @brief Position in the lazily built chunk list of a traversal.
+*
+*        This is the state behind Tree_Iterator and Const_Tree_Iterator.
+*        Copying it only bumps two reference counts, so the
+*        postincrement operator and algorithms that copy iterators no
+*        longer clone the stack or queue of the Tree_Iterator_Impl.
+*        The Tree_Iterator_Impl is only advanced to produce new chunks.
+*/
+template <typename T>
+class Tree_Iterator_Stream
+{
+public:
+	/// Start a stream at the current position of <impl>.
+	Tree_Iterator_Stream(Tree_Iterator_Impl<T> *impl)
+		:impl_{ impl }, chunk_{ Tree_Iterator_Chunk<T>::make(*impl) }, pos_{ 0 }
+	{}
+
+	/// Item at the current position, a null tree at the end.  The
+	/// chunk is shared with the copies of the stream, so the item is
+	/// read only.
+	const Tree<T> &current(void) const {
+		return chunk_.is_null() ? end_ : chunk_->items_[pos_];
+	}
+
+	/// Move to the next position, producing the next chunk if no other
+	/// copy has done so yet.
+	void advance(void) {
+		if (chunk_.is_null())
+			return;
+
+		if (++pos_ < chunk_->count_)
+			return;
+
+		if (chunk_->next_ == nullptr)
+			chunk_->next_ = Tree_Iterator_Chunk<T>::make(*impl_);
+
+		// Take our own reference on the successor before letting go of
+		// the current chunk.
+		chunk_ = Refcounter<Tree_Iterator_Chunk<T> >(chunk_->next_, true);
+		pos_ = 0;
+	}
+
+	/// Equality operator
+	bool operator== (const Tree_Iterator_Stream<T> &rhs) const {
+		return current() == rhs.current();
+	}
+
+private:
+	/// Produces the traversal, shared by all copies of the stream.
+	Refcounter <Tree_Iterator_Impl<T> > impl_;
+
+	/// Chunk holding the current position.
+	Refcounter <Tree_Iterator_Chunk<T> > chunk_;
+
+	/// Index of the current position in <chunk_>.
+	size_t pos_;
+
+	/// Returned by current() at the end.
+	Tree<T> end_;
+};
+
+#endif /* _Tree_Iterator_Stream_H */
@@ -0,0 +1,719 @@
+#pragma once
+#ifndef _Tree_Order_Iterator_H
+#define _Tree_Order_Iterator_H
+
+#include <iterator>
+#include <cstddef>
+
+#include "Tree.h"
+#include "Component_Node.h"
+#include "Inline_Stack.h"
+
+/// = Traversal order tags used to pick an iterator at compile time,
+/// e.g. tree.begin<Preorder>().  The names match the strings
+/// accepted by Tree::begin(const std::string &).
+struct Levelorder {};
+struct Preorder {};
+struct Postorder {};
+struct Inorder {};
+
+/// Tag for the traversal in <ORDER> from its last node to its first,
+/// e.g. tree.rbegin<Preorder>() is a Tree_Order_Iterator<T,
+/// Reverse<Preorder> >.  Defined for the depth first orders, which
+/// reverse by walking the mirror image of the tree; reversing the
+/// level order would take the whole traversal.
+template <typename ORDER>
+struct Reverse {};
+
+/**
+* @class Tree_Order_Iterator_Base
+* @brief Common part of the compile-time selected iterators.
+*
+*        Unlike Tree_Iterator there is no virtual Tree_Iterator_Impl
+*        behind these iterators: they are returned by value and keep
+*        their traversal state in an Inline_Stack/Inline_Queue, so
+*        iterating a small tree does no heap allocation.  The traversal
+*        state holds raw node pointers which stay valid because <root_>
+*        keeps the whole tree alive.  A default constructed iterator is
+*        the end sentinel.
+*/
+template <typename T>
+class Tree_Order_Iterator_Base
+{
+public:
+	/// Dereference operator returns a reference to the item contained
+	/// at the current position
+	Tree<T> &operator* (void) {
+		sync();
+		return current_;
+	}
+
+	/// Returns a const reference to the item contained at the current position
+	const Tree<T> &operator* (void) const {
+		sync();
+		return current_;
+	}
+
+	const Tree<T> *operator-> (void) const {
+		sync();
+		return &current_;
+	}
+
+	/// Returns the node at the current position, nullptr at the end,
+	/// without wrapping it in a Tree, for visiting it as it is passed.
+	Component_Node<T> *get_node(void) const {
+		return node_;
+	}
+
+	/// End the traversal here, the iterator compares equal to end().
+	void stop(void) {
+		node_ = nullptr;
+	}
+
+	/// Equality operator
+	bool operator== (const Tree_Order_Iterator_Base<T> &rhs) const {
+		return node_ == rhs.node_;
+	}
+
+	/// Nonequality operator
+	bool operator!= (const Tree_Order_Iterator_Base<T> &rhs) const {
+		return node_ != rhs.node_;
+	}
+
+	// = Necessary traits
+	typedef std::forward_iterator_tag iterator_category;
+	typedef Tree<T> value_type;
+	typedef Tree<T> *pointer;
+	typedef Tree<T> &reference;
+	typedef ptrdiff_t difference_type;
+
+protected:
+	/// End sentinel
+	Tree_Order_Iterator_Base(void)
+		:root_{}, node_{ nullptr }, current_{}
+	{}
+
+	/// Iterator over <tree>
+	Tree_Order_Iterator_Base(const Tree<T> &tree)
+		:root_{ tree }, node_{ nullptr }, current_{}
+	{}
+
+	/// Returns the number of nodes under <node> and itself, 0 for
+	/// nullptr.
+	static size_t size_of(const Component_Node<T> *node) {
+		return node != nullptr ? node->subtree_size() : 0;
+	}
+
+	/// Returns the most nodes a depth first traversal of <tree> keeps
+	/// on its stack, its height, or 0 if its Tree_Stats are not kept.
+	static size_t stack_bound(const Tree<T> &tree) {
+		return tree.has_stats() ? tree.stats().height_ : 0;
+	}
+
+	/// Only wrap the current node in a Tree when it is dereferenced so
+	/// that stepping over nodes does not touch their reference counts.
+	void sync(void) const {
+		if (current_.get_root() != node_)
+			current_ = Tree<T>(node_, true);
+	}
+
+	/// Keeps the nodes referenced by the traversal state alive.
+	Tree<T> root_;
+
+	/// Node at the current position, nullptr at the end.
+	Component_Node<T> *node_;
+
+	/// Handle on <node_> handed out by operator*.
+	mutable Tree<T> current_;
+};
+
+/**
+* @class Tree_Order_Iterator
+* @brief Iterator for the traversal order named by the <ORDER> tag.
+*        Only the specializations below are defined.
+*/
+template <typename T, typename ORDER>
+class Tree_Order_Iterator;
+
+/**
+* @class Tree_Order_Iterator<T, Levelorder>
+* @brief Level_Order traversal without a Queue strategy object.
+*/
+template <typename T>
+class Tree_Order_Iterator<T, Levelorder> : public Tree_Order_Iterator_Base<T>
+{
+public:
+	/// End sentinel
+	Tree_Order_Iterator(void)
+	{}
+
+	/// Constructor that takes in an entry
+	explicit Tree_Order_Iterator(const Tree<T> &tree)
+		:Tree_Order_Iterator_Base<T>(tree)
+	{
+		// The queue holds the rest of one level and the start of the
+		// next, at most two of the widest.
+		if (tree.has_stats())
+			queue_.reserve(2 * tree.stats().max_width_);
+		this->node_ = tree.get_root();
+	}
+
+	/// Preincrement operator
+	Tree_Order_Iterator<T, Levelorder> &operator++ (void) {
+		if (this->node_ != nullptr) {
+			if (this->node_->left() != nullptr)
+				queue_.enqueue(this->node_->left());
+			if (this->node_->right() != nullptr)
+				queue_.enqueue(this->node_->right());
+			next();
+		}
+		return *this;
+	}
+
+	/// Move to the next node without queueing the children of the
+	/// current one, so none of the nodes under it are visited.
+	Tree_Order_Iterator<T, Levelorder> &skip_subtree(void) {
+		if (this->node_ != nullptr)
+			next();
+		return *this;
+	}
+
+	/// Postincrement operator
+	Tree_Order_Iterator<T, Levelorder> operator++ (int) {
+		Tree_Order_Iterator<T, Levelorder> temp(*this);
+		++(*this);
+		return temp;
+	}
+
+private:
+	Inline_Queue<Component_Node<T> *> queue_;
+
+	void next(void) {
+		if (!queue_.empty()) {
+			this->node_ = queue_.front();
+			queue_.dequeue();
+		}
+		else
+			this->node_ = nullptr;
+	}
+};
+
+/**
+* @class Left_First
+* @brief Sides a depth first walk takes, left before right.
+*/
+struct Left_First
+{
+	template <typename T>
+	static Component_Node<T> *first(const Component_Node<T> *node) {
+		return node->left();
+	}
+
+	template <typename T>
+	static Component_Node<T> *second(const Component_Node<T> *node) {
+		return node->right();
+	}
+};
+
+/**
+* @class Right_First
+* @brief Sides a depth first walk takes, right before left.  A walk
+*        that takes them this way visits the mirror image of the tree,
+*        and its pre order is the reverse of the post order, its post
+*        order the reverse of the pre order and its in order the
+*        reverse of the in order.
+*/
+struct Right_First
+{
+	template <typename T>
+	static Component_Node<T> *first(const Component_Node<T> *node) {
+		return node->right();
+	}
+
+	template <typename T>
+	static Component_Node<T> *second(const Component_Node<T> *node) {
+		return node->left();
+	}
+};
+
+/**
+* @class Positioned_Walk
+* @brief Base of the depth first walks, which keep the position of the
+*        current node in the traversal.  The subtree sizes kept on the
+*        composite nodes let a walk seek a position by going down from
+*        the root, deciding at each node from the sizes of its children
+*        which one the position is under, in O(height) steps.  Each
+*        walk does that descent in its seek.
+*/
+template <typename T, typename ITERATOR>
+class Positioned_Walk : public Tree_Order_Iterator_Base<T>
+{
+public:
+	typedef typename Tree_Order_Iterator_Base<T>::difference_type difference_type;
+
+	/// Returns the number of nodes before the current one in the
+	/// traversal, the number of nodes in the tree at the end.
+	size_t position(void) const {
+		return index(total());
+	}
+
+	/// Move forward <k> nodes, or to the end if there are fewer left.
+	ITERATOR &advance(size_t k) {
+		return static_cast<ITERATOR &>(*this).seek(position() + k);
+	}
+
+	/// Returns the number of nodes from <rhs> to this iterator, which
+	/// walk the same tree or one of them is end().
+	difference_type operator- (const Positioned_Walk<T, ITERATOR> &rhs) const {
+		const size_t nodes = this->root_.is_null() ? rhs.total() : total();
+		return static_cast<difference_type>(index(nodes))
+			- static_cast<difference_type>(rhs.index(nodes));
+	}
+
+protected:
+	/// End sentinel
+	Positioned_Walk(void)
+		:position_{ 0 }
+	{}
+
+	/// Constructor that takes in an entry
+	explicit Positioned_Walk(const Tree<T> &tree)
+		:Tree_Order_Iterator_Base<T>(tree), position_{ 0 }
+	{}
+
+	/// Returns the number of nodes in the tree walked.
+	size_t total(void) const {
+		return this->size_of(this->root_.get_root());
+	}
+
+	/// Returns the position, taking the end to be at <nodes>.
+	size_t index(size_t nodes) const {
+		return this->node_ != nullptr ? position_ : nodes;
+	}
+
+	/// Position of <node_>, while it is not nullptr.
+	size_t position_;
+};
+
+/**
+* @class Pre_Order_Walk
+* @brief Pre_Order traversal taking the children in <SIDES> order, the
+*        stack only holds pending second children.  <ITERATOR> is the
+*        Tree_Order_Iterator the walk is the base of.
+*/
+template <typename T, typename SIDES, typename ITERATOR>
+class Pre_Order_Walk : public Positioned_Walk<T, ITERATOR>
+{
+public:
+	/// Preincrement operator
+	ITERATOR &operator++ (void) {
+		Component_Node<T> *node = this->node_;
+		if (node != nullptr) {
+			++this->position_;
+			if (SIDES::first(node) != nullptr) {
+				if (SIDES::second(node) != nullptr)
+					stack_.push(SIDES::second(node));
+				this->node_ = SIDES::first(node);
+			}
+			else if (SIDES::second(node) != nullptr)
+				this->node_ = SIDES::second(node);
+			else if (!stack_.empty()) {
+				this->node_ = stack_.top();
+				stack_.pop();
+			}
+			else
+				this->node_ = nullptr;
+		}
+		return static_cast<ITERATOR &>(*this);
+	}
+
+	/// Postincrement operator
+	ITERATOR operator++ (int) {
+		ITERATOR temp(static_cast<ITERATOR &>(*this));
+		++(*this);
+		return temp;
+	}
+
+	/// Move past the nodes under the current one, to the next node
+	/// that is not one of them.  Nothing of the current subtree is on
+	/// the stack yet, so this is the step that does not go down.
+	ITERATOR &skip_subtree(void) {
+		if (this->node_ != nullptr) {
+			this->position_ += this->size_of(this->node_);
+			if (!stack_.empty()) {
+				this->node_ = stack_.top();
+				stack_.pop();
+			}
+			else
+				this->node_ = nullptr;
+		}
+		return static_cast<ITERATOR &>(*this);
+	}
+
+	/// Move to the node at position <k>, or to the end if there are no
+	/// more nodes.  A node comes first, then the <k> - 1 after it are
+	/// in its first subtree or, past that, in its second.
+	ITERATOR &seek(size_t k) {
+		stack_.clear();
+		Component_Node<T> *node = this->root_.get_root();
+		if (k >= this->size_of(node))
+			node = nullptr;
+		this->position_ = k;
+
+		for (; node != nullptr && k != 0; --k) {
+			const size_t first_size = this->size_of(SIDES::first(node));
+			if (k <= first_size) {
+				if (SIDES::second(node) != nullptr)
+					stack_.push(SIDES::second(node));
+				node = SIDES::first(node);
+			}
+			else {
+				k -= first_size;
+				node = SIDES::second(node);
+			}
+		}
+		this->node_ = node;
+		return static_cast<ITERATOR &>(*this);
+	}
+
+protected:
+	/// End sentinel
+	Pre_Order_Walk(void)
+	{}
+
+	/// Constructor that takes in an entry
+	explicit Pre_Order_Walk(const Tree<T> &tree)
+		:Positioned_Walk<T, ITERATOR>(tree)
+	{
+		stack_.reserve(this->stack_bound(tree));
+		this->node_ = tree.get_root();
+	}
+
+private:
+	Inline_Stack<Component_Node<T> *> stack_;
+};
+
+/**
+* @class Post_Order_Walk
+* @brief Post_Order traversal taking the children in <SIDES> order,
+*        the stack holds the ancestors of the current node.  <ITERATOR>
+*        is the Tree_Order_Iterator the walk is the base of.
+*/
+template <typename T, typename SIDES, typename ITERATOR>
+class Post_Order_Walk : public Positioned_Walk<T, ITERATOR>
+{
+public:
+	/// Preincrement operator
+	ITERATOR &operator++ (void) {
+		if (this->node_ != nullptr) {
+			++this->position_;
+			if (stack_.empty()) {
+				this->node_ = nullptr;
+				return static_cast<ITERATOR &>(*this);
+			}
+
+			// Coming up from the first child means the second subtree
+			// of the parent still has to be visited.
+			Component_Node<T> *parent = stack_.top();
+			if (SIDES::first(parent) == this->node_ && SIDES::second(parent) != nullptr)
+				traverse_down(SIDES::second(parent));
+
+			this->node_ = stack_.top();
+			stack_.pop();
+		}
+		return static_cast<ITERATOR &>(*this);
+	}
+
+	/// Postincrement operator
+	ITERATOR operator++ (int) {
+		ITERATOR temp(static_cast<ITERATOR &>(*this));
+		++(*this);
+		return temp;
+	}
+
+	/// Move to the node at position <k>, or to the end if there are no
+	/// more nodes.  A subtree is its first subtree, its second, then
+	/// the node itself; the ancestors passed are kept on the stack.
+	ITERATOR &seek(size_t k) {
+		stack_.clear();
+		Component_Node<T> *node = this->root_.get_root();
+		if (k >= this->size_of(node))
+			node = nullptr;
+		this->position_ = k;
+
+		while (node != nullptr && k != this->size_of(node) - 1) {
+			const size_t first_size = this->size_of(SIDES::first(node));
+			stack_.push(node);
+			if (k < first_size)
+				node = SIDES::first(node);
+			else {
+				k -= first_size;
+				node = SIDES::second(node);
+			}
+		}
+		this->node_ = node;
+		return static_cast<ITERATOR &>(*this);
+	}
+
+protected:
+	/// End sentinel
+	Post_Order_Walk(void)
+	{}
+
+	/// Constructor that takes in an entry
+	explicit Post_Order_Walk(const Tree<T> &tree)
+		:Positioned_Walk<T, ITERATOR>(tree)
+	{
+		stack_.reserve(this->stack_bound(tree));
+		if (tree.get_root() != nullptr) {
+			traverse_down(tree.get_root());
+			this->node_ = stack_.top();
+			stack_.pop();
+		}
+	}
+
+private:
+	Inline_Stack<Component_Node<T> *> stack_;
+
+	/// Push the path down to the first node visited in post order.
+	void traverse_down(Component_Node<T> *node) {
+		while (node != nullptr) {
+			stack_.push(node);
+			node = SIDES::first(node) != nullptr ? SIDES::first(node) : SIDES::second(node);
+		}
+	}
+};
+
+/**
+* @class In_Order_Walk
+* @brief In_Order traversal taking the children in <SIDES> order, the
+*        stack holds the ancestors still to be visited.  <ITERATOR> is
+*        the Tree_Order_Iterator the walk is the base of.
+*/
+template <typename T, typename SIDES, typename ITERATOR>
+class In_Order_Walk : public Positioned_Walk<T, ITERATOR>
+{
+public:
+	/// Preincrement operator
+	ITERATOR &operator++ (void) {
+		if (this->node_ != nullptr) {
+			++this->position_;
+			traverse_down(SIDES::second(this->node_));
+			next();
+		}
+		return static_cast<ITERATOR &>(*this);
+	}
+
+	/// Postincrement operator
+	ITERATOR operator++ (int) {
+		ITERATOR temp(static_cast<ITERATOR &>(*this));
+		++(*this);
+		return temp;
+	}
+
+	/// Move to the node at position <k>, or to the end if there are no
+	/// more nodes.  A subtree is its first subtree, the node, then its
+	/// second; the ancestors whose first subtree is entered are still
+	/// to be visited and kept on the stack.
+	ITERATOR &seek(size_t k) {
+		stack_.clear();
+		Component_Node<T> *node = this->root_.get_root();
+		if (k >= this->size_of(node))
+			node = nullptr;
+		this->position_ = k;
+
+		while (node != nullptr) {
+			const size_t first_size = this->size_of(SIDES::first(node));
+			if (k < first_size) {
+				stack_.push(node);
+				node = SIDES::first(node);
+			}
+			else if (k == first_size)
+				break;
+			else {
+				k -= first_size + 1;
+				node = SIDES::second(node);
+			}
+		}
+		this->node_ = node;
+		return static_cast<ITERATOR &>(*this);
+	}
+
+protected:
+	/// End sentinel
+	In_Order_Walk(void)
+	{}
+
+	/// Constructor that takes in an entry
+	explicit In_Order_Walk(const Tree<T> &tree)
+		:Positioned_Walk<T, ITERATOR>(tree)
+	{
+		stack_.reserve(this->stack_bound(tree));
+		traverse_down(tree.get_root());
+		next();
+	}
+
+private:
+	Inline_Stack<Component_Node<T> *> stack_;
+
+	void traverse_down(Component_Node<T> *node) {
+		for (; node != nullptr; node = SIDES::first(node))
+			stack_.push(node);
+	}
+
+	void next(void) {
+		if (!stack_.empty()) {
+			this->node_ = stack_.top();
+			stack_.pop();
+		}
+		else
+			this->node_ = nullptr;
+	}
+};
+
+/**
+* @class Tree_Order_Iterator<T, Preorder>
+* @brief Pre_Order traversal.
+*/
+template <typename T>
+class Tree_Order_Iterator<T, Preorder>
+	: public Pre_Order_Walk<T, Left_First, Tree_Order_Iterator<T, Preorder> >
+{
+public:
+	/// End sentinel
+	Tree_Order_Iterator(void)
+	{}
+
+	/// Constructor that takes in an entry
+	explicit Tree_Order_Iterator(const Tree<T> &tree)
+		:Pre_Order_Walk<T, Left_First, Tree_Order_Iterator<T, Preorder> >(tree)
+	{}
+};
+
+/**
+* @class Tree_Order_Iterator<T, Postorder>
+* @brief Post_Order traversal.
+*/
+template <typename T>
+class Tree_Order_Iterator<T, Postorder>
+	: public Post_Order_Walk<T, Left_First, Tree_Order_Iterator<T, Postorder> >
+{
+public:
+	/// End sentinel
+	Tree_Order_Iterator(void)
+	{}
+
+	/// Constructor that takes in an entry
+	explicit Tree_Order_Iterator(const Tree<T> &tree)
+		:Post_Order_Walk<T, Left_First, Tree_Order_Iterator<T, Postorder> >(tree)
+	{}
+};
+
+/**
+* @class Tree_Order_Iterator<T, Inorder>
+* @brief In_Order traversal.
+*/
+template <typename T>
+class Tree_Order_Iterator<T, Inorder>
+	: public In_Order_Walk<T, Left_First, Tree_Order_Iterator<T, Inorder> >
+{
+public:
+	/// End sentinel
+	Tree_Order_Iterator(void)
+	{}
+
+	/// Constructor that takes in an entry
+	explicit Tree_Order_Iterator(const Tree<T> &tree)
+		:In_Order_Walk<T, Left_First, Tree_Order_Iterator<T, Inorder> >(tree)
+	{}
+};
+
+/**
+* @class Tree_Order_Iterator<T, Reverse<Preorder> >
+* @brief Pre_Order traversal from the last node to the first, as the
+*        post order of the mirror image.  It keeps no more than the
+*        forward iterators do, unlike reversing a copy of the traversal.
+*/
+template <typename T>
+class Tree_Order_Iterator<T, Reverse<Preorder> >
+	: public Post_Order_Walk<T, Right_First, Tree_Order_Iterator<T, Reverse<Preorder> > >
+{
+public:
+	/// End sentinel
+	Tree_Order_Iterator(void)
+	{}
+
+	/// Constructor that takes in an entry
+	explicit Tree_Order_Iterator(const Tree<T> &tree)
+		:Post_Order_Walk<T, Right_First, Tree_Order_Iterator<T, Reverse<Preorder> > >(tree)
+	{}
+};
+
+/**
+* @class Tree_Order_Iterator<T, Reverse<Postorder> >
+* @brief Post_Order traversal from the last node to the first, as the
+*        pre order of the mirror image.
+*/
+template <typename T>
+class Tree_Order_Iterator<T, Reverse<Postorder> >
+	: public Pre_Order_Walk<T, Right_First, Tree_Order_Iterator<T, Reverse<Postorder> > >
+{
+public:
+	/// End sentinel
+	Tree_Order_Iterator(void)
+	{}
+
+	/// Constructor that takes in an entry
+	explicit Tree_Order_Iterator(const Tree<T> &tree)
+		:Pre_Order_Walk<T, Right_First, Tree_Order_Iterator<T, Reverse<Postorder> > >(tree)
+	{}
+};
+
+/**
+* @class Tree_Order_Iterator<T, Reverse<Inorder> >
+* @brief In_Order traversal from the last node to the first, as the
+*        in order of the mirror image.
+*/
+template <typename T>
+class Tree_Order_Iterator<T, Reverse<Inorder> >
+	: public In_Order_Walk<T, Right_First, Tree_Order_Iterator<T, Reverse<Inorder> > >
+{
+public:
+	/// End sentinel
+	Tree_Order_Iterator(void)
+	{}
+
+	/// Constructor that takes in an entry
+	explicit Tree_Order_Iterator(const Tree<T> &tree)
+		:In_Order_Walk<T, Right_First, Tree_Order_Iterator<T, Reverse<Inorder> > >(tree)
+	{}
+};
+
+/**
+* @class Tree_Order_Range
+* @brief Pairs begin<ORDER>() and end<ORDER>() so a traversal can be
+*        used in a range based for loop:
+*
+*        for (const TREE &t : tree.traverse<Preorder>()) ...
+*/
+template <typename T, typename ORDER>
+class Tree_Order_Range
+{
+public:
+	explicit Tree_Order_Range(const Tree<T> &tree)
+		:tree_{ tree }
+	{}
+
+	Tree_Order_Iterator<T, ORDER> begin(void) const {
+		return Tree_Order_Iterator<T, ORDER>(tree_);
+	}
+
+	Tree_Order_Iterator<T, ORDER> end(void) const {
+		return Tree_Order_Iterator<T, ORDER>();
+	}
+
+private:
+	Tree<T> tree_;
+};
+
+#endif /* _Tree_Order_Iterator_H */
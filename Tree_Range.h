@@ -0,0 +1,229 @@
+#pragma once
+#ifndef _Tree_Range_H
+#define _Tree_Range_H
+
+// This header defines "size_t"
+#include <stdlib.h>
+#include <vector>
+#include <algorithm>
+#include <thread>
+#include <atomic>
+
+#include "Tree.h"
+#include "Component_Node.h"
+#include "Inline_Stack.h"
+
+/**
+* @class Tree_Range
+* @brief The nodes of part of a tree, in no particular order, that can
+*        be split into two parts of about the same size, e.g. to hand
+*        the parts of a traversal to several threads.
+*
+*        A range is a list of pieces.  A piece is the subtree under a
+*        node less the subtree under one of its descendants on the
+*        heavy path, the path that always goes on to the child with
+*        more nodes, or a single node.  A piece splits at the node on
+*        that path where about half of its nodes are above and half
+*        below, found with the sizes kept on the composite nodes in a
+*        step per level.  A balanced tree splits near its root; a tree
+*        shaped like a list splits part of the way down its spine.
+*
+*        A range keeps the tree alive.  The nodes are only read, so
+*        the ranges split from one tree may be walked on different
+*        threads at once; copying and splitting ranges must stay on
+*        one thread, since that copies Tree handles.
+*/
+template <typename T>
+class Tree_Range
+{
+public:
+	/// Ctor - every node of <tree>.
+	explicit Tree_Range(const Tree<T> &tree)
+		:tree_{ tree }, size_{ 0 }
+	{
+		if (!tree.is_null()) {
+			Piece whole = { tree.get_root(), nullptr, false };
+			pieces_.push_back(whole);
+			size_ = piece_size(whole);
+		}
+	}
+
+	/// Returns the number of nodes in the range.
+	size_t size(void) const {
+		return size_;
+	}
+
+	/// Returns true if the range can be split.
+	bool is_divisible(void) const {
+		return size_ > 1;
+	}
+
+	/// Move about half of the nodes of this range to the range
+	/// returned.  The range must be divisible.
+	Tree_Range<T> split(void) {
+		// Split the largest piece while it is more than half of the
+		// range, then deal the pieces, largest first, to whichever half
+		// has fewer nodes.
+		for (;;) {
+			std::sort(pieces_.begin(), pieces_.end(), &Tree_Range<T>::larger);
+			if (piece_size(pieces_[0]) <= size_ / 2 || pieces_[0].single_)
+				break;
+			split_piece(pieces_[0]);
+		}
+
+		std::vector<Piece> pieces;
+		pieces.swap(pieces_);
+		Tree_Range<T> other(tree_, 0);
+		size_ = 0;
+		for (size_t i = 0; i < pieces.size(); ++i) {
+			Tree_Range<T> &half = size_ <= other.size_ ? *this : other;
+			half.pieces_.push_back(pieces[i]);
+			half.size_ += piece_size(pieces[i]);
+		}
+		return other;
+	}
+
+	/// Split the range into up to <count> ranges, splitting the
+	/// largest one each time.
+	std::vector<Tree_Range<T> > split_into(size_t count) const {
+		std::vector<Tree_Range<T> > ranges(1, *this);
+		while (ranges.size() < count) {
+			size_t largest = 0;
+			for (size_t i = 1; i < ranges.size(); ++i)
+				if (ranges[i].size() > ranges[largest].size())
+					largest = i;
+			if (!ranges[largest].is_divisible())
+				break;
+			Tree_Range<T> other = ranges[largest].split();
+			ranges.push_back(other);
+		}
+		return ranges;
+	}
+
+	/// Call <f> with every node of the range.
+	template <typename FUNCTION>
+	void for_each(FUNCTION f) const {
+		Inline_Stack<Component_Node<T> *> stack;
+		for (size_t i = 0; i < pieces_.size(); ++i) {
+			const Piece &piece = pieces_[i];
+			if (piece.single_) {
+				f(piece.node_);
+				continue;
+			}
+			stack.push(piece.node_);
+			while (!stack.empty()) {
+				Component_Node<T> *node = stack.top();
+				stack.pop();
+				f(node);
+				if (node->right() != nullptr && node->right() != piece.stop_)
+					stack.push(node->right());
+				if (node->left() != nullptr && node->left() != piece.stop_)
+					stack.push(node->left());
+			}
+		}
+	}
+
+private:
+	/// The nodes under <node_> and <node_> itself, less those under
+	/// <stop_> and <stop_> itself, or only <node_> if <single_>.
+	struct Piece
+	{
+		Component_Node<T> *node_;
+		Component_Node<T> *stop_;
+		bool single_;
+	};
+
+	/// Ctor - an empty range of <tree>.
+	Tree_Range(const Tree<T> &tree, size_t)
+		:tree_{ tree }, size_{ 0 }
+	{}
+
+	/// Returns the number of nodes under <node> and itself.
+	static size_t size_of(const Component_Node<T> *node) {
+		return node != nullptr ? node->subtree_size() : 0;
+	}
+
+	/// Returns the child of <node> with more nodes, the left one if
+	/// they have as many.
+	static Component_Node<T> *heavier(const Component_Node<T> *node) {
+		return size_of(node->left()) >= size_of(node->right()) ? node->left() : node->right();
+	}
+
+	/// Returns the number of nodes in <piece>.
+	static size_t piece_size(const Piece &piece) {
+		return piece.single_ ? 1 : size_of(piece.node_) - size_of(piece.stop_);
+	}
+
+	/// Orders the pieces largest first.
+	static bool larger(const Piece &lhs, const Piece &rhs) {
+		return piece_size(lhs) > piece_size(rhs);
+	}
+
+	/// Split <piece>, which has more than one node, into two and
+	/// append the second.  Going down the heavy path from its top, the
+	/// first node with at most half of the piece under it, less what
+	/// the piece leaves out, is where it splits.  If the top's heavier
+	/// child is left out already, the top and its other child are the
+	/// two parts.
+	void split_piece(Piece &piece) {
+		Component_Node<T> *top = piece.node_;
+		Component_Node<T> *cut = heavier(top);
+		if (cut == piece.stop_) {
+			Piece light = { cut == top->left() ? top->right() : top->left(), nullptr, false };
+			piece.single_ = true;
+			pieces_.push_back(light);
+			return;
+		}
+
+		const size_t half = piece_size(piece) / 2;
+		while (size_of(cut) - size_of(piece.stop_) > half && heavier(cut) != piece.stop_)
+			cut = heavier(cut);
+		Piece below = { cut, piece.stop_, false };
+		piece.stop_ = cut;
+		pieces_.push_back(below);
+	}
+
+	/// Keeps the nodes alive.
+	Tree<T> tree_;
+
+	/// The pieces of the range.
+	std::vector<Piece> pieces_;
+
+	/// Number of nodes in <pieces_>.
+	size_t size_;
+};
+
+/// Call <f>(node, worker) for every node of <tree> on <threads> threads,
+/// or as many as the hardware runs at once if 0.  The nodes are visited
+/// in no particular order, a few Tree_Range chunks per thread taken in
+/// turn, so threads that finish early take more.  <worker> numbers the
+/// threads from 0, the calling thread, so <f> can keep what it finds
+/// per thread and merge it afterwards, e.g. with one visitor each.  <f>
+/// must not throw and must not copy Tree handles to the nodes.
+template <typename T, typename FUNCTION>
+void parallel_for_each(const Tree<T> &tree, FUNCTION f, size_t threads = 0)
+{
+	if (threads == 0)
+		threads = std::thread::hardware_concurrency();
+	if (threads == 0)
+		threads = 1;
+
+	const size_t CHUNKS_PER_THREAD = 4;
+	const std::vector<Tree_Range<T> > chunks =
+		Tree_Range<T>(tree).split_into(threads * CHUNKS_PER_THREAD);
+
+	std::atomic<size_t> next{ 0 };
+	auto work = [&](size_t worker) {
+		for (size_t i = next.fetch_add(1); i < chunks.size(); i = next.fetch_add(1))
+			chunks[i].for_each([&](Component_Node<T> *node) { f(node, worker); });
+	};
+
+	std::vector<std::thread> workers;
+	for (size_t worker = 1; worker < threads; ++worker)
+		workers.push_back(std::thread(work, worker));
+	work(0);
+	for (size_t i = 0; i < workers.size(); ++i)
+		workers[i].join();
+}
+
+#endif /* _Tree_Range_H */
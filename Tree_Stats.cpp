@@ -0,0 +1,83 @@
+#include "stdafx.h"
+#if !defined (_Tree_Stats_CPP)
+#define _Tree_Stats_CPP
+
+#include "Tree_Stats.h"
+#include "Visitor.h"
+#include "Component_Node.h"
+#include "Leaf_Node.h"
+#include "Composite_Negate_Node.h"
+#include "Composite_Add_Node.h"
+#include "Composite_Subtract_Node.h"
+#include "Composite_Multiply_Node.h"
+#include "Composite_Divide_Node.h"
+
+namespace
+{
+	/// Names of the kinds in <Node_Kind> order.
+	const char *kind_names[NODE_KIND_COUNT] = {
+		"leaf",
+		"negate",
+		"add",
+		"subtract",
+		"multiply",
+		"divide"
+	};
+
+	/// Visitor that tells which <Node_Kind> a node is.
+	class Kind_Visitor : public Visitor
+	{
+	public:
+		virtual void visit(const LEAF_NODE &) { kind_ = LEAF_KIND; }
+		virtual void visit(const COMPOSITE_NEGATE_NODE &) { kind_ = NEGATE_KIND; }
+		virtual void visit(const COMPOSITE_ADD_NODE &) { kind_ = ADD_KIND; }
+		virtual void visit(const COMPOSITE_SUBTRACT_NODE &) { kind_ = SUBTRACT_KIND; }
+		virtual void visit(const COMPOSITE_MULTIPLY_NODE &) { kind_ = MULTIPLY_KIND; }
+		virtual void visit(const COMPOSITE_DIVIDE_NODE &) { kind_ = DIVIDE_KIND; }
+
+		Node_Kind kind_;
+	};
+}
+
+// Walk the tree, telling the kinds of the nodes apart with a visitor.
+Tree_Stats::Tree_Stats(Component_Node<int> *root)
+	:use_{ 1 }
+{
+	Kind_Visitor kind;
+	walk(root, [&](Component_Node<int> *node) {
+		node->accept(kind);
+		++kinds_[kind.kind_];
+	});
+}
+
+// Returns the share of the nodes that are leaves.
+double
+Tree_Stats::leaf_ratio(void) const
+{
+	return nodes_ != 0 ? static_cast<double>(kinds_[LEAF_KIND]) / nodes_ : 0;
+}
+
+// Print the statistics one per line.
+void
+Tree_Stats::print(std::ostream &output) const
+{
+	output << "nodes," << nodes_ << std::endl;
+	for (size_t i = 0; i < NODE_KIND_COUNT; ++i)
+		output << kind_names[i] << "_nodes," << kinds_[i] << std::endl;
+	output << "immediate_leaves," << immediate_leaves_ << std::endl
+		<< "leaf_ratio," << leaf_ratio() << std::endl
+		<< "height," << height_ << std::endl
+		<< "max_width," << max_width_ << std::endl
+		<< "widest_level," << widest_level_ << std::endl
+		<< "node_bytes," << node_bytes_ << std::endl
+		<< "allocated_bytes," << allocated_bytes_ << std::endl;
+}
+
+// Returns the name <kind> is printed under.
+const char *
+Tree_Stats::kind_name(Node_Kind kind)
+{
+	return kind_names[kind];
+}
+
+#endif /* _Tree_Stats_CPP */
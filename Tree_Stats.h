@@ -0,0 +1,189 @@
+#pragma once
+#ifndef _Tree_Stats_H
+#define _Tree_Stats_H
+
+// This header defines "size_t"
+#include <stdlib.h>
+#include <iostream>
+#include <vector>
+
+#include "Typedefs.h"
+#include "Node_Allocator.h"
+#include "Inline_Stack.h"
+
+template <typename T>
+class Component_Node;
+
+template <typename T>
+class Refcounter;
+
+/// Subtypes of Component_Node counted by Tree_Stats.
+enum Node_Kind
+{
+	LEAF_KIND,
+	NEGATE_KIND,
+	ADD_KIND,
+	SUBTRACT_KIND,
+	MULTIPLY_KIND,
+	DIVIDE_KIND,
+	NODE_KIND_COUNT
+};
+
+/**
+* @class Tree_Stats
+* @brief The shape and size of an expression tree, found by one walk
+*        over its nodes, e.g. to size the stacks and queues of a
+*        traversal or to spot pathological input.
+*
+*        Tree::stats makes them the first time they are asked for and
+*        keeps them with the tree, so every copy of the handle shares
+*        one Tree_Stats.  They describe the tree as it was then; trees
+*        are not changed after they are built.
+*
+*        The kinds of the nodes are told apart with a Visitor, which
+*        only visits nodes of int.  The stats of a tree of another item
+*        type have its shape and size but no <kinds_>.
+*/
+class Tree_Stats
+{
+	/// Needed for reference counting.
+	friend class Refcounter<Tree_Stats>;
+
+public:
+	/// Ctor - walk the tree at <root>, which may be nullptr.
+	Tree_Stats(Component_Node<int> *root);
+
+	/// Ctor - walk the tree at <root> of another item type, leaving
+	/// <kinds_> at 0.
+	template <typename T>
+	explicit Tree_Stats(Component_Node<T> *root)
+		:use_{ 1 }
+	{
+		walk(root, [](Component_Node<T> *) {});
+	}
+
+	/// Returns the share of the nodes that are leaves.
+	double leaf_ratio(void) const;
+
+	/// Print one "name,value" line per statistic.
+	void print(std::ostream &output) const;
+
+	/// Returns the name <kind> is printed under.
+	static const char *kind_name(Node_Kind kind);
+
+	size_t nodes_;
+	// Number of nodes.
+
+	size_t kinds_[NODE_KIND_COUNT];
+	// Number of nodes of each <Node_Kind>.
+
+	size_t immediate_leaves_;
+	// Leaves stored inside their parent, see Node_Child.
+
+	size_t height_;
+	// Number of levels, 0 for an empty tree.
+
+	size_t max_width_;
+	// Most nodes on one level.
+
+	size_t widest_level_;
+	// First level with <max_width_> nodes, the root's level is 0.
+
+	size_t node_bytes_;
+	// Sum of the sizes of the nodes that have their own memory.  An
+	// immediate leaf is part of its parent's size.
+
+	size_t allocated_bytes_;
+	// <node_bytes_> as the Node_Allocator lays them out: each node
+	// rounded up to the slab alignment, plus the slab headers, if the
+	// nodes filled their slabs one after the other.
+
+private:
+	/// A node still to be counted, its level, and whether it is built
+	/// inside its parent.
+	template <typename T>
+	struct Frame
+	{
+		Component_Node<T> *node_;
+		size_t level_;
+		bool inside_;
+	};
+
+	/// Walk the tree at <root> depth first, counting each level's nodes
+	/// on the way, and calling <count_kind>(node) for every node.
+	template <typename T, typename COUNT_KIND>
+	void walk(Component_Node<T> *root, COUNT_KIND count_kind);
+
+	/// Reference count, for Tree's handle to the stats.
+	int use_;
+};
+
+template <typename T, typename COUNT_KIND>
+void
+Tree_Stats::walk(Component_Node<T> *root, COUNT_KIND count_kind)
+{
+	nodes_ = immediate_leaves_ = height_ = max_width_ = widest_level_ = 0;
+	node_bytes_ = allocated_bytes_ = 0;
+	for (size_t i = 0; i < NODE_KIND_COUNT; ++i)
+		kinds_[i] = 0;
+	if (root == nullptr)
+		return;
+
+	std::vector<size_t> widths;
+	size_t slab_bytes = 0;
+
+	Inline_Stack<Frame<T> > stack;
+	Frame<T> first = { root, 0, false };
+	stack.push(first);
+
+	while (!stack.empty()) {
+		const Frame<T> frame = stack.top();
+		stack.pop();
+		Component_Node<T> *node = frame.node_;
+
+		++nodes_;
+		count_kind(node);
+
+		if (frame.level_ == widths.size())
+			widths.push_back(0);
+		++widths[frame.level_];
+
+		const size_t size = node->node_size();
+		if (frame.inside_)
+			++immediate_leaves_;
+		else {
+			node_bytes_ += size;
+			if (size > Node_Allocator::MAX_SIZE)
+				allocated_bytes_ += Node_Allocator::allocated_size(size);
+			else
+				slab_bytes += Node_Allocator::allocated_size(size);
+		}
+
+		// A child is built inside its parent if its address is within
+		// the parent's <size> bytes.
+		const char *begin = reinterpret_cast<const char *>(node);
+		Component_Node<T> *children[] = { node->right(), node->left() };
+		for (size_t c = 0; c < 2; ++c) {
+			if (children[c] == nullptr)
+				continue;
+			const char *address = reinterpret_cast<const char *>(children[c]);
+			Frame<T> next = { children[c], frame.level_ + 1,
+				address >= begin && address < begin + size };
+			stack.push(next);
+		}
+	}
+
+	// Slabs filled one after the other, the last one partly.
+	const size_t header = Node_Allocator::slab_header_size();
+	const size_t per_slab = Node_Allocator::SLAB_SIZE - header;
+	allocated_bytes_ += slab_bytes + (slab_bytes + per_slab - 1) / per_slab * header;
+
+	height_ = widths.size();
+	for (size_t level = 0; level < widths.size(); ++level)
+		if (widths[level] > max_width_) {
+			max_width_ = widths[level];
+			widest_level_ = level;
+		}
+}
+
+#endif /* _Tree_Stats_H */
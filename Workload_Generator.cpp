@@ -0,0 +1,491 @@
+#include "stdafx.h"
+#if !defined (_Workload_Generator_CPP)
+#define _Workload_Generator_CPP
+
+#include <sstream>
+#include <algorithm>
+
+#include "Workload_Generator.h"
+#include "Leaf_Node.h"
+#include "Node_Child.h"
+#include "Composite_Negate_Node.h"
+#include "Composite_Add_Node.h"
+#include "Composite_Subtract_Node.h"
+#include "Composite_Multiply_Node.h"
+#include "Composite_Divide_Node.h"
+
+namespace
+{
+	/// Kinds of Workload_Generator::Frame.
+	enum { EXPAND, RIGHT, CLOSE };
+
+	/// Bits of Workload_Generator::Frame::flags_.
+	enum { RIGHT_OPERAND = 1, NEGATED = 2, WRAPPED = 4 };
+
+	/// Levels of an expression without a depth limit.
+	const uint32_t UNLIMITED = 0xFFFFFFFF;
+
+	/// Binary operators in the order of Workload_Spec::weights_.
+	const char operators[] = { '+', '-', '*', '/' };
+
+	/// Precedence of a binary operator, as the Interpreter sees it.
+	int precedence(char op)
+	{
+		return op == '*' || op == '/' ? 2 : 1;
+	}
+
+	/// Returns true if an operator <op> must be in parentheses as an
+	/// operand of <parent>, the right one if <right>.
+	bool needs_parens(char parent, bool right, char op)
+	{
+		if (parent == 0)
+			return false;
+		return precedence(op) < precedence(parent)
+			|| (right && precedence(op) == precedence(parent));
+	}
+
+	/// Step of the splitmix64 generator.
+	uint64_t mix(uint64_t &state)
+	{
+		uint64_t z = (state += 0x9E3779B97F4A7C15ULL);
+		z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+		z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+		return z ^ (z >> 31);
+	}
+
+	/// Returns <text> converted to T, or throws Invalid_Spec naming <key>.
+	template <typename T>
+	T convert(const std::string &key, const std::string &text)
+	{
+		std::istringstream input(text);
+		T value;
+		if (!(input >> value) || !input.eof())
+			throw Workload_Generator::Invalid_Spec("bad value for " + key + ": " + text);
+		return value;
+	}
+}
+
+// Writes the walk as a string.
+class Workload_Generator::Expression_Writer
+{
+public:
+	Expression_Writer(std::ostream &output)
+		:output_(output)
+	{}
+
+	void number(int value, bool negate, bool wrap) {
+		if (negate)
+			output_ << '-';
+		if (wrap)
+			output_ << '(';
+		output_ << value;
+		if (wrap)
+			output_ << ')';
+	}
+
+	void variable(size_t index, int, bool negate, bool wrap) {
+		if (negate)
+			output_ << '-';
+		if (wrap)
+			output_ << '(';
+		output_ << 'x' << index;
+		if (wrap)
+			output_ << ')';
+	}
+
+	void open(char, bool negate, bool wrap) {
+		if (negate)
+			output_ << '-';
+		if (wrap)
+			output_ << '(';
+	}
+
+	void middle(char op) {
+		output_ << op;
+	}
+
+	void close(char, bool, bool wrap) {
+		if (wrap)
+			output_ << ')';
+	}
+
+private:
+	std::ostream &output_;
+};
+
+// Builds the walk as a tree, children before their parent.  Operands
+// become immediate leaves of their parent, see Node_Child.
+class Workload_Generator::Tree_Builder
+{
+public:
+	Tree_Builder(void)
+		:built_()
+	{}
+
+	void number(int value, bool negate, bool) {
+		Built operand;
+		operand.node_ = nullptr;
+		operand.item_ = value;
+		if (negate)
+			operand.node_ = new COMPOSITE_NEGATE_NODE(Node_Child<int>::immediate(value));
+		built_.push_back(operand);
+	}
+
+	void variable(size_t, int value, bool negate, bool wrap) {
+		number(value, negate, wrap);
+	}
+
+	void open(char, bool, bool) {
+	}
+
+	void middle(char) {
+	}
+
+	void close(char op, bool negate, bool) {
+		const Node_Child<int> right = child(built_.back());
+		built_.pop_back();
+		const Node_Child<int> left = child(built_.back());
+		built_.pop_back();
+
+		Component_Node<int> *node = nullptr;
+		switch (op) {
+		case '+':
+			node = new COMPOSITE_ADD_NODE(left, right);
+			break;
+		case '-':
+			node = new COMPOSITE_SUBTRACT_NODE(left, right);
+			break;
+		case '*':
+			node = new COMPOSITE_MULTIPLY_NODE(left, right);
+			break;
+		default:
+			node = new COMPOSITE_DIVIDE_NODE(left, right);
+			break;
+		}
+		if (negate)
+			node = new COMPOSITE_NEGATE_NODE(node);
+
+		Built built;
+		built.node_ = node;
+		built.item_ = 0;
+		built_.push_back(built);
+	}
+
+	/// Returns the whole tree once the walk is done.
+	Component_Node<int> *root(void) const {
+		const Built &root = built_.back();
+		return root.node_ != nullptr ? root.node_ : new LEAF_NODE(root.item_);
+	}
+
+private:
+	/// A node built, or an operand not built yet.
+	struct Built
+	{
+		Component_Node<int> *node_;
+		int item_;
+	};
+
+	static Node_Child<int> child(const Built &built) {
+		if (built.node_ != nullptr)
+			return Node_Child<int>(built.node_);
+		return Node_Child<int>::immediate(built.item_);
+	}
+
+	std::vector<Built> built_;
+};
+
+// Ctor
+Workload_Spec::Workload_Spec(void)
+	:operands_{ 100 }, max_depth_{ 0 }, shape_{ RANDOM_SHAPE },
+	parens_{ 0 }, variables_{ 0 }, variable_rate_{ 0.25 }, seed_{ 1 }, count_{ 1 }
+{
+	weights_[0] = weights_[1] = weights_[2] = weights_[3] = 4;
+	weights_[4] = 1;
+}
+
+// Ctor
+Workload_Generator::Workload_Generator(const Workload_Spec &spec)
+	:spec_(spec), state_{ spec.seed_ }, frames_()
+{
+	if (spec_.operands_ == 0)
+		throw Invalid_Spec("operands must be at least 1");
+	if (spec_.max_depth_ != 0 && capacity(spec_.max_depth_) < spec_.operands_)
+		throw Invalid_Spec("depth is too small for that many operands");
+	if (spec_.operands_ > 1 && spec_.weights_[0] + spec_.weights_[1] + spec_.weights_[2] == 0)
+		throw Invalid_Spec("ops needs one of +, - or *");
+	if (spec_.parens_ < 0 || spec_.parens_ > 1
+		|| spec_.variable_rate_ < 0 || spec_.variable_rate_ > 1)
+		throw Invalid_Spec("parens and variable_rate must be between 0 and 1");
+}
+
+// Dtor
+Workload_Generator::~Workload_Generator(void)
+{
+}
+
+// Returns the spec described by <text>.
+Workload_Spec
+Workload_Generator::parse_spec(const std::string &text)
+{
+	Workload_Spec spec;
+	std::istringstream input(text);
+
+	for (std::string pair; std::getline(input, pair, ',');) {
+		if (pair.empty())
+			continue;
+		const std::string::size_type equals = pair.find('=');
+		if (equals == std::string::npos)
+			throw Invalid_Spec("expected key=value: " + pair);
+		const std::string key = pair.substr(0, equals);
+		const std::string value = pair.substr(equals + 1);
+
+		if (key == "operands")
+			spec.operands_ = convert<size_t>(key, value);
+		else if (key == "depth")
+			spec.max_depth_ = convert<size_t>(key, value);
+		else if (key == "shape") {
+			if (value == "left")
+				spec.shape_ = LEFT_DEEP_SHAPE;
+			else if (value == "right")
+				spec.shape_ = RIGHT_DEEP_SHAPE;
+			else if (value == "random")
+				spec.shape_ = RANDOM_SHAPE;
+			else if (value == "balanced")
+				spec.shape_ = BALANCED_SHAPE;
+			else
+				throw Invalid_Spec("unknown shape: " + value);
+		}
+		else if (key == "ops") {
+			// Each operator listed is followed by its weight, 1 if left
+			// out; the operators not listed get 0.
+			const std::string names = "+-*/~";
+			std::fill(spec.weights_, spec.weights_ + 5, 0);
+			for (std::string::size_type i = 0; i < value.size();) {
+				const std::string::size_type op = names.find(value[i]);
+				if (op == std::string::npos)
+					throw Invalid_Spec("unknown operator in ops: " + value);
+				std::string::size_type end = i + 1;
+				while (end < value.size() && value[end] >= '0' && value[end] <= '9')
+					++end;
+				spec.weights_[op] = end > i + 1
+					? convert<unsigned int>(key, value.substr(i + 1, end - i - 1)) : 1;
+				i = end;
+			}
+		}
+		else if (key == "parens")
+			spec.parens_ = convert<double>(key, value);
+		else if (key == "variables")
+			spec.variables_ = convert<size_t>(key, value);
+		else if (key == "variable_rate")
+			spec.variable_rate_ = convert<double>(key, value);
+		else if (key == "seed")
+			spec.seed_ = convert<uint64_t>(key, value);
+		else if (key == "count")
+			spec.count_ = convert<size_t>(key, value);
+		else
+			throw Invalid_Spec("unknown key: " + key);
+	}
+	return spec;
+}
+
+// Returns the next expression as a string.
+std::string
+Workload_Generator::expression(void)
+{
+	std::ostringstream output;
+	expression(output);
+	return output.str();
+}
+
+// Write the next expression to <output>.
+void
+Workload_Generator::expression(std::ostream &output)
+{
+	Expression_Writer writer(output);
+	walk(writer);
+}
+
+// Returns the next expression built directly as a tree.
+TREE
+Workload_Generator::tree(void)
+{
+	Tree_Builder builder;
+	walk(builder);
+	TREE tree(builder.root());
+	tree.stats();
+	return tree;
+}
+
+// Give every variable its value in <context>.
+void
+Workload_Generator::bind(Interpreter_Context &context) const
+{
+	for (size_t i = 0; i < spec_.variables_; ++i) {
+		std::ostringstream name;
+		name << 'x' << i;
+		context.set(name.str(), variable_value(i));
+	}
+}
+
+// Returns the value of variable <index>.  It depends only on the seed
+// and <index>, not on how much of the stream has been used.
+int
+Workload_Generator::variable_value(size_t index) const
+{
+	uint64_t state = spec_.seed_ ^ (static_cast<uint64_t>(index) << 32);
+	return 1 + static_cast<int>(mix(state) % 9);
+}
+
+// Returns the spec.
+const Workload_Spec &
+Workload_Generator::spec(void) const
+{
+	return spec_;
+}
+
+// Generate one expression.  Every subtree draws its negation, extra
+// parentheses, operator and split when it is expanded, which is in
+// preorder whatever <output> does with it, so a writer and a builder
+// draw the same numbers.
+template <typename OUTPUT>
+void
+Workload_Generator::walk(OUTPUT &output)
+{
+	const unsigned int *weights = spec_.weights_;
+	const double negate_rate = static_cast<double>(weights[4])
+		/ (weights[0] + weights[1] + weights[2] + weights[3] + weights[4]);
+
+	Frame root = { spec_.operands_, static_cast<uint32_t>(std::min<size_t>(
+		spec_.max_depth_ ? spec_.max_depth_ : UNLIMITED, UNLIMITED)), 0, EXPAND, 0 };
+	frames_.clear();
+	frames_.push_back(root);
+
+	while (!frames_.empty()) {
+		Frame &frame = frames_.back();
+
+		if (frame.kind_ == RIGHT) {
+			// The left operand is done, the frame waits on for the right.
+			Frame right = { frame.operands_, frame.levels_, frame.op_, EXPAND, RIGHT_OPERAND };
+			output.middle(frame.op_);
+			frame.kind_ = CLOSE;
+			frames_.push_back(right);
+			continue;
+		}
+		if (frame.kind_ == CLOSE) {
+			output.close(frame.op_, (frame.flags_ & NEGATED) != 0, (frame.flags_ & WRAPPED) != 0);
+			frames_.pop_back();
+			continue;
+		}
+
+		const Frame expand = frame;
+		frames_.pop_back();
+
+		const bool negate = chance(negate_rate);
+		const bool extra = chance(spec_.parens_);
+		const bool right_operand = (expand.flags_ & RIGHT_OPERAND) != 0;
+		const size_t operands = static_cast<size_t>(expand.operands_);
+
+		if (operands == 1) {
+			// The right operand of a Divide is never a variable, which
+			// the Pipeline would read as 0.
+			const bool divisor = expand.op_ == '/' && right_operand;
+			if (!divisor && spec_.variables_ > 0 && chance(spec_.variable_rate_)) {
+				const size_t index = uniform(spec_.variables_);
+				output.variable(index, variable_value(index), negate, extra);
+			}
+			else
+				output.number(1 + static_cast<int>(uniform(9)), negate, extra);
+			continue;
+		}
+
+		// Narrow the split so both sides fit in the levels left.
+		const uint32_t levels = expand.levels_ == UNLIMITED ? UNLIMITED : expand.levels_ - 1;
+		const size_t most = std::min(operands - 1, capacity(levels));
+		const size_t least = operands - std::min(operands - 1, capacity(levels));
+
+		size_t left = 0;
+		switch (spec_.shape_) {
+		case LEFT_DEEP_SHAPE:
+			left = most;
+			break;
+		case RIGHT_DEEP_SHAPE:
+			left = least;
+			break;
+		case RANDOM_SHAPE:
+			left = least + uniform(most - least + 1);
+			break;
+		case BALANCED_SHAPE:
+			left = operands / 2;
+			break;
+		}
+
+		const char op = draw_operator(operands - left == 1);
+		const bool wrap = extra || negate || needs_parens(expand.op_, right_operand, op);
+		output.open(op, negate, wrap);
+
+		const Frame pending = { operands - left, levels, op, RIGHT,
+			static_cast<unsigned char>((negate ? NEGATED : 0) | (wrap ? WRAPPED : 0)) };
+		const Frame left_operand = { left, levels, op, EXPAND, 0 };
+		frames_.push_back(pending);
+		frames_.push_back(left_operand);
+	}
+}
+
+// Returns the next number of the random stream.
+uint64_t
+Workload_Generator::next(void)
+{
+	return mix(state_);
+}
+
+// Returns a number drawn uniformly from 0 to <bound> - 1.
+size_t
+Workload_Generator::uniform(size_t bound)
+{
+	return static_cast<size_t>(next() % bound);
+}
+
+// Returns true with probability <p>.  Draws nothing when <p> is 0, so
+// turning a feature off does not change the rest of the expression.
+bool
+Workload_Generator::chance(double p)
+{
+	if (p <= 0)
+		return false;
+	return (next() >> 11) / 9007199254740992.0 < p;
+}
+
+// Returns the binary operator drawn from the weights.
+char
+Workload_Generator::draw_operator(bool may_divide)
+{
+	unsigned int total = 0;
+	for (size_t i = 0; i < 4; ++i)
+		if (may_divide || operators[i] != '/')
+			total += spec_.weights_[i];
+	if (total == 0)
+		return 0;
+
+	size_t drawn = uniform(total);
+	for (size_t i = 0; i < 4; ++i) {
+		if (!may_divide && operators[i] == '/')
+			continue;
+		if (drawn < spec_.weights_[i])
+			return operators[i];
+		drawn -= spec_.weights_[i];
+	}
+	return 0;
+}
+
+// Returns the most operands a subtree of <levels> levels holds.
+size_t
+Workload_Generator::capacity(size_t levels)
+{
+	if (levels == 0)
+		return 0;
+	if (levels - 1 >= sizeof(size_t) * 8 - 1)
+		return static_cast<size_t>(-1);
+	return static_cast<size_t>(1) << (levels - 1);
+}
+
+#endif /* _Workload_Generator_CPP */
@@ -0,0 +1,206 @@
+#pragma once
+#ifndef _Workload_Generator_H
+#define _Workload_Generator_H
+
+// This header defines "size_t"
+#include <stdlib.h>
+#include <stdint.h>
+#include <string>
+#include <iostream>
+#include <vector>
+
+#include "Tree.h"
+#include "Interpreter.h"
+
+/// How the operands are split between the two sides of each operator.
+enum Workload_Shape
+{
+	LEFT_DEEP_SHAPE,
+	// Every right operand is a single operand: ((1+2)+3)+4.
+
+	RIGHT_DEEP_SHAPE,
+	// Every left operand is a single operand: 1+(2+(3+4)).
+
+	RANDOM_SHAPE,
+	// Each split is drawn uniformly.
+
+	BALANCED_SHAPE
+	// Each side gets half of the operands.
+};
+
+/// What Workload_Generator generates.
+struct Workload_Spec
+{
+	Workload_Spec(void);
+
+	size_t operands_;
+	// Operands per expression.  An expression has operands_ - 1 binary
+	// operators, plus the negations.
+
+	size_t max_depth_;
+	// Most operators and operand on a path from the root down to an
+	// operand, not counting negations, or 0 for no limit.  The splits
+	// of every shape are narrowed to stay within it.
+
+	Workload_Shape shape_;
+	// How the operands are split between the sides of an operator.
+
+	unsigned int weights_[5];
+	// Relative weights of Add, Subtract, Multiply, Divide and Negate.
+	// Each operator is drawn from the first four; every node is negated
+	// with probability weights_[4] over the sum of all five.  A Divide
+	// is only drawn when its right operand is a single number, so
+	// evaluation never divides by 0.
+
+	double parens_;
+	// Probability of putting parentheses the expression does not need
+	// around an operand or an operator, which deepens the nesting the
+	// Interpreter sees.
+
+	size_t variables_;
+	// Number of distinct variables, named x0, x1 and so on.
+
+	double variable_rate_;
+	// Probability that an operand is a variable when there are any.
+
+	uint64_t seed_;
+	// Seed of the random stream.  The same spec always generates the
+	// same expressions in the same order.
+
+	size_t count_;
+	// Expressions to print in the -g command line mode.
+};
+
+/**
+* @class Workload_Generator
+* @brief Generates expressions of a controlled size and shape, as
+*        strings for the Interpreter or as trees built directly.
+*
+*        Both forms come out of the same walk over the same random
+*        stream, so the n-th string and the n-th tree of two generators
+*        with the same spec are the same expression.  The walk is
+*        iterative and nothing but the output is kept, so generating a
+*        left or right deep expression of a hundred million nodes needs
+*        no more stack than a small one.  Building that many nodes with
+*        tree() is still bounded by memory, and the Interpreter still
+*        parses deep strings recursively.
+*/
+class Workload_Generator
+{
+public:
+	/// Invalid_Spec class for exceptions when a spec cannot be parsed
+	/// or cannot be generated.
+
+	class Invalid_Spec
+	{
+	public:
+		Invalid_Spec(const std::string &msg)
+		{
+			msg_ = msg;
+		}
+
+		const std::string what(void)
+		{
+			return msg_;
+		}
+	private:
+		std::string msg_;
+	};
+
+	/// Ctor - throws Invalid_Spec if <spec> cannot be generated.
+	Workload_Generator(const Workload_Spec &spec);
+
+	/// Dtor
+	~Workload_Generator(void);
+
+	/// Returns the spec described by <text>, a comma separated list of
+	/// key=value pairs such as "operands=1000,shape=random,seed=7".
+	/// The keys are operands, depth, shape (left, right, random or
+	/// balanced), ops (the weights of + - * / and ~ for negate, e.g.
+	/// "+2-1*1/1~1" or just "+*"), parens, variables, variable_rate,
+	/// seed and count.  Keys left out keep their default.
+	static Workload_Spec parse_spec(const std::string &text);
+
+	/// Returns the next expression as a string.
+	std::string expression(void);
+
+	/// Write the next expression to <output>.
+	void expression(std::ostream &output);
+
+	/// Returns the next expression built directly as a tree, with each
+	/// variable replaced by its value and its Tree_Stats kept with it.
+	TREE tree(void);
+
+	/// Give every variable its value in <context>.
+	void bind(Interpreter_Context &context) const;
+
+	/// Returns the value of variable <index>, from 1 to 9.
+	int variable_value(size_t index) const;
+
+	/// Returns the spec.
+	const Workload_Spec &spec(void) const;
+
+private:
+	/// One step of the walk.  Each operator being generated has one
+	/// frame waiting, so the frames of a deep expression take 16 bytes
+	/// per level.
+	struct Frame
+	{
+		uint64_t operands_;
+		// EXPAND: operands of the subtree.  RIGHT: operands of the right
+		// operand.
+
+		uint32_t levels_;
+		// Levels the subtree or the right operand may use.
+
+		char op_;
+		// EXPAND: operator of the parent, 0 at the root.  RIGHT and
+		// CLOSE: the operator itself.
+
+		unsigned char kind_;
+		// EXPAND, RIGHT (the left operand is being generated) or CLOSE
+		// (the right operand is).
+
+		unsigned char flags_;
+		// RIGHT_OPERAND, NEGATED and WRAPPED bits.
+	};
+
+	/// Writes the walk as a string.
+	class Expression_Writer;
+
+	/// Builds the walk as a tree.
+	class Tree_Builder;
+
+	/// Generate one expression, calling <output> for each part of it
+	/// from left to right.
+	template <typename OUTPUT>
+	void walk(OUTPUT &output);
+
+	/// Returns the next number of the random stream.
+	uint64_t next(void);
+
+	/// Returns a number drawn uniformly from 0 to <bound> - 1.
+	size_t uniform(size_t bound);
+
+	/// Returns true with probability <p>.
+	bool chance(double p);
+
+	/// Returns the binary operator drawn from the weights, or 0 if all
+	/// their weights are 0.  Divide is drawn only if <may_divide>.
+	char draw_operator(bool may_divide);
+
+	/// Returns the most operands a subtree of <levels> levels holds.
+	static size_t capacity(size_t levels);
+
+	/// The spec being generated.
+	Workload_Spec spec_;
+
+	/// State of the random stream.
+	uint64_t state_;
+
+	/// Steps of the walk still to be taken, kept between calls so its
+	/// memory is reused.
+	std::vector<Frame> frames_;
+};
+
+#endif /* _Workload_Generator_H */
@@ -13,3 +13,7 @@
 
 
 // TODO: reference additional headers your program requires here
+
+// Uncomment, or define in the project settings, to count the hot path
+// operations listed in Hot_Counters.h.  Print the counts with -c.
+// #define HOT_PATH_COUNTERS